@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+#include <ext/any.hpp>
+
+#include "bench.hpp"
+
+
+namespace
+{
+    struct large
+    {
+        double values[8];
+    };
+
+    template<typename T>
+    void run(char const* type_name, T const& value)
+    {
+        std::size_t const n = 1000000;
+        std::vector<ext::any> const source(n, ext::any(value));
+
+        std::string const prefix = std::string(type_name) + " ";
+
+        auto const none = [] { return 0; };
+        auto const empty = [&] { return std::vector<ext::any>(n); };
+        auto const copy = [&] { return std::vector<ext::any>(source); };
+
+        bench::measure((prefix + "copy").c_str(), n, empty,
+                       [&](std::vector<ext::any>& values) {
+            for (std::size_t i = 0; i < n; ++i)
+                values[i] = source[i];
+            bench::do_not_optimize(values.data());
+        });
+
+        auto const copy_and_empty = [&] {
+            std::vector<ext::any> values(2 * n);
+            std::copy(source.begin(), source.end(), values.begin());
+            return values;
+        };
+
+        bench::measure((prefix + "move").c_str(), n, copy_and_empty,
+                       [&](std::vector<ext::any>& values) {
+            for (std::size_t i = 0; i < n; ++i)
+                values[n + i] = std::move(values[i]);
+            bench::do_not_optimize(values.data());
+        });
+
+        bench::measure((prefix + "destroy").c_str(), n, copy,
+                       [&](std::vector<ext::any>& values) {
+            for (auto& element : values)
+                element.reset();
+            bench::do_not_optimize(values.data());
+        });
+
+        bench::measure((prefix + "has_value_of").c_str(), n, none, [&](int) {
+            std::size_t count = 0;
+            for (auto const& element : source)
+                count += element.has_value_of<T>();
+            bench::do_not_optimize(count);
+        });
+    }
+
+    void run_dispatch()
+    {
+        std::size_t const n = 1000000;
+        std::vector<ext::any> values;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            switch (i % 4)
+            {
+            case 0: values.emplace_back(int(i)); break;
+            case 1: values.emplace_back(long(i)); break;
+            case 2: values.emplace_back(double(i)); break;
+            case 3: values.emplace_back(float(i)); break;
+            }
+        }
+
+        auto const none = [] { return 0; };
+
+        bench::measure("dispatch has_value_of chain", n, none, [&](int) {
+            double sum = 0;
+            for (auto const& value : values)
+            {
+                if (value.has_value_of<int>())
+                    sum += value.value<int>();
+                else if (value.has_value_of<long>())
+                    sum += double(value.value<long>());
+                else if (value.has_value_of<double>())
+                    sum += value.value<double>();
+                else if (value.has_value_of<float>())
+                    sum += value.value<float>();
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::measure("dispatch visit", n, none, [&](int) {
+            double sum = 0;
+            for (auto const& value : values)
+            {
+                sum += ext::visit<int, long, double, float>(
+                    value, [](auto x) { return double(x); });
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+int main()
+{
+    run("int", 42);
+    run("std::string", std::string("a string that does not fit in place"));
+    run("large", large {{1, 2, 3, 4, 5, 6, 7, 8}});
+    run_dispatch();
+}
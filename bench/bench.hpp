@@ -0,0 +1,51 @@
+/*
+ * Minimal timing helper for benchmarks.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_BENCH_BENCH_HPP
+#define EXT_BENCH_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+
+namespace bench
+{
+    /*
+     * Runs fn(setup()) the given number of times and prints the best time per
+     * item, where each run processes `items` items. Only fn is timed.
+     */
+    template<typename Setup, typename Fn>
+    void measure(char const* name, std::size_t items, Setup setup, Fn fn,
+                 int runs = 10)
+    {
+        using clock = std::chrono::steady_clock;
+
+        double best = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < runs; ++i)
+        {
+            auto input = setup();
+            auto const start = clock::now();
+            fn(input);
+            auto const end = clock::now();
+            std::chrono::duration<double, std::nano> const elapsed = end - start;
+            best = std::min(best, elapsed.count());
+        }
+        std::printf("%-40s %8.2f ns/item\n", name, best / double(items));
+    }
+
+    /*
+     * Prevents the compiler from optimizing away the computation of value.
+     */
+    template<typename T>
+    void do_not_optimize(T const& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+}
+
+#endif
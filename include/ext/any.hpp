@@ -8,10 +8,17 @@
 #define EXT_ANY_HPP
 
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 
-#include "clone_ptr.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#include "memory_resource.hpp"
+#include "type_map.hpp"
 
 namespace ext
 {
@@ -19,46 +26,209 @@ namespace ext
     // Type erasure
     //--------------------------------------------------------------------------
 
-    struct placeholder
+    namespace detail
     {
-        virtual
-        ~placeholder() = default;
+        /*
+         * Storage of the contained object. Small objects live in the buffer;
+         * others are allocated from a memory resource and pointed to by
+         * `heap`.
+         */
+        union any_storage
+        {
+            void* heap;
+            std::aligned_storage_t<3 * sizeof(void*), alignof(void*)> buffer;
+        };
 
-        virtual
-        std::unique_ptr<placeholder> clone() const = 0;
-    };
+        /*
+         * True if objects of type T are stored in the buffer.
+         */
+        template<typename T>
+        struct any_is_local : std::integral_constant<bool,
+            sizeof(T) <= sizeof(any_storage) &&
+            alignof(any_storage) % alignof(T) == 0 &&
+            std::is_nothrow_move_constructible<T>::value>
+        {
+        };
+
+        /*
+         * Functions operating on the contained object, one table per type.
+         * `move` move-constructs the object into the destination and destroys
+         * the source. It is null if copying the storage bytes does the same,
+         * which is the case for heap-allocated objects and trivially copyable
+         * local objects.
+         */
+        struct any_vtable_base
+        {
+            ext::type_id type;
+            void (*destroy)(any_storage& storage) noexcept;
+            void (*move)(any_storage& source, any_storage& dest) noexcept;
+        };
+
+        /*
+         * Function table of copyable objects. `copy` allocates from given
+         * resource, or from the resource of the source if it is null.
+         */
+        struct any_vtable
+        {
+            any_vtable_base base;
+            void (*copy)(any_storage const& source,
+                         any_storage& dest,
+                         ext::memory_resource* resource);
+        };
+
+        /*
+         * Heap-allocated object along with the resource it came from.
+         */
+        template<typename T>
+        struct any_heap_block
+        {
+            ext::memory_resource* resource;
+            T value;
 
-    template<typename T>
-    struct holder : placeholder
-    {
-        T value;
+            template<typename... Args>
+            explicit
+            any_heap_block(ext::memory_resource* res, Args&&... args)
+                : resource {res}
+                , value(std::forward<Args>(args)...)
+            {
+            }
+        };
 
-        holder(T const& init)
-            : value {init}
-        {
-        }
+        template<typename T, bool = any_is_local<T>::value>
+        struct any_handler;
 
-        holder(T& init)
-            : value {init}
+        template<typename T>
+        struct any_handler<T, true>
         {
-        }
+            static T& get(any_storage& storage) noexcept
+            {
+                return *reinterpret_cast<T*>(&storage.buffer);
+            }
+
+            static T const& get(any_storage const& storage) noexcept
+            {
+                return *reinterpret_cast<T const*>(&storage.buffer);
+            }
+
+            template<typename... Args>
+            static void create(any_storage& storage,
+                               ext::memory_resource*,
+                               Args&&... args)
+            {
+                ::new(&storage.buffer) T(std::forward<Args>(args)...);
+            }
+
+            static void destroy(any_storage& storage) noexcept
+            {
+                get(storage).~T();
+            }
+
+            static void move(any_storage& source, any_storage& dest) noexcept
+            {
+                create(dest, nullptr, std::move(get(source)));
+                destroy(source);
+            }
+
+            static void copy(any_storage const& source,
+                             any_storage& dest,
+                             ext::memory_resource*)
+            {
+                create(dest, nullptr, get(source));
+            }
+
+            static constexpr any_vtable_base vtable_base()
+            {
+                return {
+                    ext::type_id_of<T>(),
+                    destroy,
+                    std::is_trivially_copyable<T>::value ? nullptr : move
+                };
+            }
+        };
 
-        holder(T&& init) noexcept
-            : value {std::move(init)}
+        template<typename T>
+        struct any_handler<T, false>
         {
-        }
+            using block = any_heap_block<T>;
+
+            static T& get(any_storage& storage) noexcept
+            {
+                return static_cast<block*>(storage.heap)->value;
+            }
+
+            static T const& get(any_storage const& storage) noexcept
+            {
+                return static_cast<block const*>(storage.heap)->value;
+            }
+
+            template<typename... Args>
+            static void create(any_storage& storage,
+                               ext::memory_resource* resource,
+                               Args&&... args)
+            {
+                storage.heap = ext::new_object<block>(
+                    resource, resource, std::forward<Args>(args)...);
+            }
+
+            static void destroy(any_storage& storage) noexcept
+            {
+                auto const ptr = static_cast<block*>(storage.heap);
+                ext::delete_object(ptr->resource, ptr);
+            }
+
+            static void copy(any_storage const& source,
+                             any_storage& dest,
+                             ext::memory_resource* resource)
+            {
+                auto const ptr = static_cast<block const*>(source.heap);
+                create(dest, resource ? resource : ptr->resource, ptr->value);
+            }
+
+            static constexpr any_vtable_base vtable_base()
+            {
+                return {ext::type_id_of<T>(), destroy, nullptr};
+            }
+        };
+
+        /*
+         * Function tables for type T. These are separate templates so that
+         * move-only types do not instantiate the copy function.
+         */
+        template<typename T>
+        struct any_vtable_of
+        {
+            static constexpr any_vtable value = {
+                any_handler<T>::vtable_base(), any_handler<T>::copy
+            };
+        };
 
-        template<typename... Args>
-        holder(Args&&... args)
-            : value(std::forward<Args>(args)...)
+        template<typename T>
+        struct unique_any_vtable_of
         {
-        }
+            static constexpr any_vtable_base value =
+                any_handler<T>::vtable_base();
+        };
+
+        template<typename T>
+        constexpr any_vtable any_vtable_of<T>::value;
+
+        template<typename T>
+        constexpr any_vtable_base unique_any_vtable_of<T>::value;
 
-        std::unique_ptr<placeholder> clone() const override
+        /*
+         * Moves the object in source to dest and destroys the source.
+         */
+        inline
+        void any_relocate(any_vtable_base const& vtable,
+                          any_storage& source,
+                          any_storage& dest) noexcept
         {
-            return std::make_unique<holder>(value);
+            if (vtable.move)
+                vtable.move(source, dest);
+            else
+                std::memcpy(&dest, &source, sizeof dest);
         }
-    };
+    }
 
     //--------------------------------------------------------------------------
     // Any
@@ -66,9 +236,17 @@ namespace ext
 
     /**
      * Object that holds an instance of any type.
+     *
+     * Values of nothrow move constructible types up to three pointers in size
+     * are stored in place without dynamic allocation. Larger values are
+     * allocated from a memory resource, `ext::new_delete_resource()` unless
+     * specified otherwise. Copy, move and destruction dispatch through a
+     * static table of functions for the contained type.
      */
     struct any
     {
+        friend struct unique_any;
+
         //----------------------------------------------------------------------
         // Constructors and assignment operator
         //----------------------------------------------------------------------
@@ -81,19 +259,56 @@ namespace ext
         /**
          * Constructs an object with initial content.
          */
-        template<typename T>
+        template<typename T,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<T>, any>::value, int> = 0>
         any(T&& value)
-            : data_ {new ext::holder<std::decay_t<T>>(std::forward<T>(value))}
         {
+            emplace<std::decay_t<T>>(std::forward<T>(value));
+        }
+
+        /**
+         * Constructs an object with initial content. If the content is not
+         * stored in place, it is allocated from given resource.
+         *
+         * Copies of the object allocate from the same resource, so the
+         * resource must outlive them as well.
+         */
+        template<typename T,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<T>, any>::value, int> = 0>
+        any(std::allocator_arg_t, ext::memory_resource* resource, T&& value)
+        {
+            using handler = detail::any_handler<std::decay_t<T>>;
+
+            handler::create(storage_, resource, std::forward<T>(value));
+            vtable_ = &detail::any_vtable_of<std::decay_t<T>>::value;
+        }
+
+        /**
+         * Copies the content of other, allocating from given resource instead
+         * of the resource of other.
+         */
+        any(std::allocator_arg_t,
+            ext::memory_resource* resource,
+            any const& other)
+        {
+            if (other.vtable_)
+            {
+                other.vtable_->copy(other.storage_, storage_, resource);
+                vtable_ = other.vtable_;
+            }
         }
 
         /**
          * Assigns specified type and value.
          */
-        template<typename T>
+        template<typename T,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<T>, any>::value, int> = 0>
         any& operator=(T&& value)
         {
-            any(std::forward<T>(value)).swap(*this);
+            *this = any(std::forward<T>(value));
             return *this;
         }
 
@@ -104,24 +319,52 @@ namespace ext
         /**
          * Copy constructor
          */
-        any(any const&) = default;
-        any(any&) = default;
+        any(any const& other)
+        {
+            if (other.vtable_)
+            {
+                other.vtable_->copy(other.storage_, storage_, nullptr);
+                vtable_ = other.vtable_;
+            }
+        }
 
         /**
          * Move constructor
          */
-        any(any&&) = default;
+        any(any&& other) noexcept
+        {
+            steal(other);
+        }
 
         /**
          * Copy assignment
          */
-        any& operator=(any const&) = default;
-        any& operator=(any&) = default;
+        any& operator=(any const& other)
+        {
+            *this = any(other);
+            return *this;
+        }
 
         /**
          * Move assignment
          */
-        any& operator=(any&&) = default;
+        any& operator=(any&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                steal(other);
+            }
+            return *this;
+        }
+
+        /**
+         * Destructor
+         */
+        ~any()
+        {
+            reset();
+        }
 
         //----------------------------------------------------------------------
         // Modifiers
@@ -129,11 +372,24 @@ namespace ext
 
         /**
          * Changes the contained object by constructing a new object directly.
+         * The old content is kept if the construction throws.
+         *
+         * An object that is not stored in place is allocated from
+         * `ext::new_delete_resource()`, whatever resource the old content
+         * came from. Assign an object constructed with `std::allocator_arg`
+         * to use another resource.
          */
         template<typename T, typename... Args>
         void emplace(Args&&... args)
         {
-            data_.reset(new ext::holder<T>(std::forward<Args>(args)...));
+            // Construct aside so that the content is kept if this throws.
+            detail::any_storage storage;
+            detail::any_handler<T>::create(storage,
+                                           ext::new_delete_resource(),
+                                           std::forward<Args>(args)...);
+            reset();
+            vtable_ = &detail::any_vtable_of<T>::value;
+            detail::any_relocate(vtable_->base, storage, storage_);
         }
 
         /**
@@ -141,7 +397,11 @@ namespace ext
          */
         void reset() noexcept
         {
-            data_.reset();
+            if (vtable_)
+            {
+                vtable_->base.destroy(storage_);
+                vtable_ = nullptr;
+            }
         }
 
         /**
@@ -149,7 +409,241 @@ namespace ext
          */
         void swap(any& other) noexcept
         {
-            data_.swap(other.data_);
+            any tmp {std::move(other)};
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        //----------------------------------------------------------------------
+        // Observers
+        //----------------------------------------------------------------------
+
+        /**
+         * Checks if object holds a value.
+         */
+        bool has_value() const noexcept
+        {
+            return vtable_ != nullptr;
+        }
+
+        /**
+         * Checks if object holds a value of specified type.
+         *
+         * The check compares type identifiers and does not need RTTI.
+         */
+        template<typename T>
+        bool has_value_of() const noexcept
+        {
+            return type() == ext::type_id_of<T>();
+        }
+
+        /**
+         * Returns the identifier of the type of the contained object, or null
+         * if the object is empty.
+         */
+        ext::type_id type() const noexcept
+        {
+            return vtable_ ? vtable_->base.type : nullptr;
+        }
+
+        /**
+         * Accesses the contained object.
+         *
+         * This function does not check dynamic type. Behaviour is undefined if
+         * specified type does not match the dynamic type.
+         */
+        template<typename T>
+        T& value()
+        {
+            return detail::any_handler<T>::get(storage_);
+        }
+
+        template<typename T>
+        T const& value() const
+        {
+            return detail::any_handler<T>::get(storage_);
+        }
+
+      private:
+        /*
+         * Takes the content of other, which is left empty. This object must
+         * be empty.
+         */
+        void steal(any& other) noexcept
+        {
+            if (other.vtable_)
+            {
+                detail::any_relocate(
+                    other.vtable_->base, other.storage_, storage_);
+                vtable_ = other.vtable_;
+                other.vtable_ = nullptr;
+            }
+        }
+
+        detail::any_vtable const* vtable_ = nullptr;
+        detail::any_storage storage_;
+    };
+
+    //--------------------------------------------------------------------------
+    // Unique any
+    //--------------------------------------------------------------------------
+
+    /**
+     * Move-only object that holds an instance of any move constructible type.
+     *
+     * Unlike `ext::any`, the contained type need not be copyable and no copy
+     * function is instantiated for it. Storage is the same as `ext::any`, so
+     * an `ext::any` rvalue converts to `unique_any` without reallocation.
+     */
+    struct unique_any
+    {
+        //----------------------------------------------------------------------
+        // Constructors and assignment operator
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs an empty object.
+         */
+        unique_any() = default;
+
+        /**
+         * Constructs an object with initial content.
+         */
+        template<typename T,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<T>, unique_any>::value &&
+                     !std::is_same<std::decay_t<T>, any>::value, int> = 0>
+        unique_any(T&& value)
+        {
+            emplace<std::decay_t<T>>(std::forward<T>(value));
+        }
+
+        /**
+         * Constructs an object with initial content. If the content is not
+         * stored in place, it is allocated from given resource.
+         */
+        template<typename T,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<T>, unique_any>::value &&
+                     !std::is_same<std::decay_t<T>, any>::value, int> = 0>
+        unique_any(std::allocator_arg_t,
+                   ext::memory_resource* resource,
+                   T&& value)
+        {
+            using handler = detail::any_handler<std::decay_t<T>>;
+
+            handler::create(storage_, resource, std::forward<T>(value));
+            vtable_ = &detail::unique_any_vtable_of<std::decay_t<T>>::value;
+        }
+
+        /**
+         * Takes the content of an `ext::any`, which is left empty.
+         */
+        unique_any(any&& other) noexcept
+        {
+            if (other.vtable_)
+            {
+                detail::any_relocate(
+                    other.vtable_->base, other.storage_, storage_);
+                vtable_ = &other.vtable_->base;
+                other.vtable_ = nullptr;
+            }
+        }
+
+        /**
+         * Assigns specified type and value.
+         */
+        template<typename T,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<T>, unique_any>::value, int> = 0>
+        unique_any& operator=(T&& value)
+        {
+            *this = unique_any(std::forward<T>(value));
+            return *this;
+        }
+
+        //----------------------------------------------------------------------
+        // Special member functions
+        //----------------------------------------------------------------------
+
+        unique_any(unique_any const&) = delete;
+        unique_any& operator=(unique_any const&) = delete;
+
+        /**
+         * Move constructor
+         */
+        unique_any(unique_any&& other) noexcept
+        {
+            steal(other);
+        }
+
+        /**
+         * Move assignment
+         */
+        unique_any& operator=(unique_any&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                steal(other);
+            }
+            return *this;
+        }
+
+        /**
+         * Destructor
+         */
+        ~unique_any()
+        {
+            reset();
+        }
+
+        //----------------------------------------------------------------------
+        // Modifiers
+        //----------------------------------------------------------------------
+
+        /**
+         * Changes the contained object by constructing a new object directly.
+         * The old content is kept if the construction throws.
+         *
+         * An object that is not stored in place is allocated from
+         * `ext::new_delete_resource()`, whatever resource the old content
+         * came from. Assign an object constructed with `std::allocator_arg`
+         * to use another resource.
+         */
+        template<typename T, typename... Args>
+        void emplace(Args&&... args)
+        {
+            // Construct aside so that the content is kept if this throws.
+            detail::any_storage storage;
+            detail::any_handler<T>::create(storage,
+                                           ext::new_delete_resource(),
+                                           std::forward<Args>(args)...);
+            reset();
+            vtable_ = &detail::unique_any_vtable_of<T>::value;
+            detail::any_relocate(*vtable_, storage, storage_);
+        }
+
+        /**
+         * Destroys contained object.
+         */
+        void reset() noexcept
+        {
+            if (vtable_)
+            {
+                vtable_->destroy(storage_);
+                vtable_ = nullptr;
+            }
+        }
+
+        /**
+         * Swaps two `unique_any` objects.
+         */
+        void swap(unique_any& other) noexcept
+        {
+            unique_any tmp {std::move(other)};
+            other = std::move(*this);
+            *this = std::move(tmp);
         }
 
         //----------------------------------------------------------------------
@@ -161,7 +655,7 @@ namespace ext
          */
         bool has_value() const noexcept
         {
-            return data_ != nullptr;
+            return vtable_ != nullptr;
         }
 
         /**
@@ -170,7 +664,16 @@ namespace ext
         template<typename T>
         bool has_value_of() const noexcept
         {
-            return dynamic_cast<ext::holder<T>*>(data_.get()) != nullptr;
+            return type() == ext::type_id_of<T>();
+        }
+
+        /**
+         * Returns the identifier of the type of the contained object, or null
+         * if the object is empty.
+         */
+        ext::type_id type() const noexcept
+        {
+            return vtable_ ? vtable_->type : nullptr;
         }
 
         /**
@@ -182,18 +685,151 @@ namespace ext
         template<typename T>
         T& value()
         {
-            return static_cast<ext::holder<T>&>(*data_).value;
+            return detail::any_handler<T>::get(storage_);
         }
 
         template<typename T>
         T const& value() const
         {
-            return static_cast<ext::holder<T>&>(*data_).value;
+            return detail::any_handler<T>::get(storage_);
         }
 
       private:
-        ext::clone_ptr<ext::placeholder> data_;
+        void steal(unique_any& other) noexcept
+        {
+            if (other.vtable_)
+            {
+                detail::any_relocate(*other.vtable_, other.storage_, storage_);
+                vtable_ = other.vtable_;
+                other.vtable_ = nullptr;
+            }
+        }
+
+        detail::any_vtable_base const* vtable_ = nullptr;
+        detail::any_storage storage_;
     };
+
+    //--------------------------------------------------------------------------
+    // Visitation
+    //--------------------------------------------------------------------------
+
+    namespace detail
+    {
+        /*
+         * Compares the type of the content with each of Ts in order and calls
+         * fun with the first match, or fallback if none matches. Type
+         * identifiers are addresses fixed at link time, so each step is a
+         * compare with a constant.
+         */
+        template<typename R, typename Any, typename F, typename Fallback>
+        R any_visit_chain(Any& any, ext::type_id, F&, Fallback& fallback)
+        {
+            return static_cast<R>(fallback(any));
+        }
+
+        template<typename R,
+                 typename Any,
+                 typename F,
+                 typename Fallback,
+                 typename T,
+                 typename... Ts>
+        R any_visit_chain(Any& any, ext::type_id type, F& fun, Fallback& fallback)
+        {
+            if (type == ext::type_id_of<T>())
+                return fun(any.template value<T>());
+            return any_visit_chain<R, Any, F, Fallback, Ts...>(
+                any, type, fun, fallback);
+        }
+
+        template<typename Any, typename F, typename Fallback, typename... Ts>
+        decltype(auto) any_visit(Any& any, F& fun, Fallback& fallback)
+        {
+            static_assert(sizeof...(Ts) > 0, "type list must not be empty");
+
+            using result_type = std::common_type_t<
+                decltype(fun(any.template value<Ts>()))...
+            >;
+            return any_visit_chain<result_type, Any, F, Fallback, Ts...>(
+                any, any.type(), fun, fallback);
+        }
+
+        /*
+         * Fallback used when none is given.
+         */
+        template<typename R>
+        struct any_visit_unreachable
+        {
+            template<typename Any>
+            R operator()(Any&) const
+            {
+                assert(!"content type is not in the visited type list");
+                std::abort();
+            }
+        };
+    }
+
+    /**
+     * Calls `fun(any.value<T>())` where T is the type of the content among
+     * `Ts`, or `fallback(any)` if the object is empty or holds a type not in
+     * `Ts`.
+     *
+     * Dispatch compares the type identifier of the content with those of
+     * `Ts` in order. The identifiers are link-time constants, so this needs
+     * no table lookup or static initialization; put frequent types first.
+     * The result type is the common type of the results of `fun` for all
+     * `Ts`.
+     *
+     * === Example ===
+     *
+     * ```
+     * auto const text = ext::visit<int, double, std::string>(
+     *     attribute,
+     *     [](auto const& value) { return to_text(value); },
+     *     [](ext::any const&) { return std::string("?"); });
+     * ```
+     */
+    template<typename... Ts, typename F, typename Fallback>
+    decltype(auto) visit(ext::any& any, F&& fun, Fallback&& fallback)
+    {
+        return detail::any_visit<ext::any, F, Fallback, Ts...>(
+            any, fun, fallback);
+    }
+
+    template<typename... Ts, typename F, typename Fallback>
+    decltype(auto) visit(ext::any const& any, F&& fun, Fallback&& fallback)
+    {
+        return detail::any_visit<ext::any const, F, Fallback, Ts...>(
+            any, fun, fallback);
+    }
+
+    /**
+     * Calls `fun(any.value<T>())` where T is the type of the content among
+     * `Ts`.
+     *
+     * Behaviour is undefined if the object is empty or holds a type not in
+     * `Ts`.
+     */
+    template<typename... Ts, typename F>
+    decltype(auto) visit(ext::any& any, F&& fun)
+    {
+        using result_type = std::common_type_t<
+            decltype(fun(any.template value<Ts>()))...
+        >;
+        detail::any_visit_unreachable<result_type> fallback;
+        return detail::any_visit<ext::any, F, decltype(fallback), Ts...>(
+            any, fun, fallback);
+    }
+
+    template<typename... Ts, typename F>
+    decltype(auto) visit(ext::any const& any, F&& fun)
+    {
+        using result_type = std::common_type_t<
+            decltype(fun(any.template value<Ts>()))...
+        >;
+        detail::any_visit_unreachable<result_type> fallback;
+        return detail::any_visit<ext::any const, F, decltype(fallback), Ts...>(
+            any, fun, fallback);
+    }
 }
 
 #endif
@@ -0,0 +1,449 @@
+/*
+ * Contiguous storage of values of any types.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_ANY_VECTOR_HPP
+#define EXT_ANY_VECTOR_HPP
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+#include "type_map.hpp"
+
+namespace ext
+{
+    namespace detail
+    {
+        /*
+         * Functions and layout of an element type. `move` move-constructs
+         * the object into the destination and destroys the source; it is null
+         * if copying bytes does the same. `copy` is null for types that are
+         * not copy constructible.
+         */
+        struct any_vector_vtable
+        {
+            ext::type_id type;
+            std::size_t size;
+            std::size_t alignment;
+            bool trivially_destructible;
+            void (*destroy)(void* object) noexcept;
+            void (*move)(void* source, void* dest) noexcept;
+            void (*copy)(void const* source, void* dest);
+        };
+
+        template<typename T>
+        struct any_vector_handler
+        {
+            static void destroy(void* object) noexcept
+            {
+                static_cast<T*>(object)->~T();
+            }
+
+            static void move(void* source, void* dest) noexcept
+            {
+                auto& object = *static_cast<T*>(source);
+                ::new(dest) T(std::move(object));
+                object.~T();
+            }
+
+            static void copy(void const* source, void* dest)
+            {
+                ::new(dest) T(*static_cast<T const*>(source));
+            }
+        };
+
+        /*
+         * Selects the copy function so that it is not instantiated for types
+         * that are not copy constructible.
+         */
+        template<typename T, bool = std::is_copy_constructible<T>::value>
+        struct any_vector_copy_of
+        {
+            static constexpr
+            void (*get() noexcept)(void const*, void*)
+            {
+                return any_vector_handler<T>::copy;
+            }
+        };
+
+        template<typename T>
+        struct any_vector_copy_of<T, false>
+        {
+            static constexpr
+            void (*get() noexcept)(void const*, void*)
+            {
+                return nullptr;
+            }
+        };
+
+        template<typename T>
+        struct any_vector_vtable_of
+        {
+            using handler = any_vector_handler<T>;
+
+            static constexpr any_vector_vtable value = {
+                ext::type_id_of<T>(),
+                sizeof(T),
+                alignof(T),
+                std::is_trivially_destructible<T>::value,
+                handler::destroy,
+                std::is_trivially_copyable<T>::value ? nullptr : handler::move,
+                any_vector_copy_of<T>::get()
+            };
+        };
+
+        template<typename T>
+        constexpr any_vector_vtable any_vector_vtable_of<T>::value;
+    }
+
+    /**
+     * Sequence of values of any types stored in a single byte arena.
+     *
+     * Each value is placed at the next suitably aligned offset in the arena,
+     * and a per-element entry records its type and offset. Iterating over
+     * the values thus walks contiguous memory. `for_each<T>` visits the
+     * values of one type with static dispatch, and `clear()` skips
+     * destructor calls entirely when all values are trivially destructible.
+     *
+     * Value types must be nothrow move constructible and must not be
+     * over-aligned. Growing the arena relocates values, so references to
+     * values are invalidated by insertion.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::any_vector attributes;
+     * attributes.push_back(42);
+     * attributes.push_back(std::string("name"));
+     * attributes.push_back(3.14);
+     *
+     * attributes.for_each<int>([](int& value) { value *= 2; });
+     * ```
+     */
+    struct any_vector
+    {
+        using size_type = std::size_t;
+
+        //----------------------------------------------------------------------
+        // Construction
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs an empty vector.
+         */
+        any_vector() = default;
+
+        /**
+         * Copies all values of other.
+         *
+         * Behaviour is undefined if other holds a value of a type that is not
+         * copy constructible.
+         */
+        any_vector(any_vector const& other)
+            : any_vector()
+        {
+            reserve(other.size(), other.size_);
+            for (auto const& entry : other.entries_)
+            {
+                assert(entry.vtable->copy);
+                entry.vtable->copy(other.data_ + entry.offset, data_ + entry.offset);
+                entries_.push_back(entry);
+                nontrivial_ += !entry.vtable->trivially_destructible;
+            }
+            size_ = other.size_;
+        }
+
+        /**
+         * Takes all values of other, which is left empty.
+         */
+        any_vector(any_vector&& other) noexcept
+            : entries_ {std::move(other.entries_)}
+            , data_ {other.data_}
+            , size_ {other.size_}
+            , capacity_ {other.capacity_}
+            , nontrivial_ {other.nontrivial_}
+        {
+            other.entries_.clear();
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.capacity_ = 0;
+            other.nontrivial_ = 0;
+        }
+
+        any_vector& operator=(any_vector const& other)
+        {
+            any_vector(other).swap(*this);
+            return *this;
+        }
+
+        any_vector& operator=(any_vector&& other) noexcept
+        {
+            any_vector(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        ~any_vector()
+        {
+            clear();
+            ::operator delete(data_);
+        }
+
+        /**
+         * Swaps the contents with other.
+         */
+        void swap(any_vector& other) noexcept
+        {
+            using std::swap;
+            swap(entries_, other.entries_);
+            swap(data_, other.data_);
+            swap(size_, other.size_);
+            swap(capacity_, other.capacity_);
+            swap(nontrivial_, other.nontrivial_);
+        }
+
+        //----------------------------------------------------------------------
+        // Capacity
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the number of values.
+         */
+        size_type size() const noexcept
+        {
+            return entries_.size();
+        }
+
+        /**
+         * Checks if there is no value.
+         */
+        bool empty() const noexcept
+        {
+            return entries_.empty();
+        }
+
+        /**
+         * Returns the number of arena bytes in use.
+         */
+        size_type bytes() const noexcept
+        {
+            return size_;
+        }
+
+        /**
+         * Reserves space for given number of values occupying given number of
+         * arena bytes in total.
+         */
+        void reserve(size_type count, size_type bytes)
+        {
+            entries_.reserve(count);
+            if (bytes > capacity_)
+                reallocate(bytes);
+        }
+
+        //----------------------------------------------------------------------
+        // Modifiers
+        //----------------------------------------------------------------------
+
+        /**
+         * Appends a value and returns a reference to the stored copy.
+         */
+        template<typename T>
+        std::decay_t<T>& push_back(T&& value)
+        {
+            return emplace_back<std::decay_t<T>>(std::forward<T>(value));
+        }
+
+        /**
+         * Appends a value of type T constructed from given arguments and
+         * returns a reference to it.
+         */
+        template<typename T, typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            static_assert(std::is_nothrow_move_constructible<T>::value,
+                          "value type must be nothrow move constructible");
+            static_assert(alignof(T) <= alignof(std::max_align_t),
+                          "over-aligned value type is not supported");
+
+            auto const& vtable = detail::any_vector_vtable_of<T>::value;
+
+            auto const offset = align_up(size_, alignof(T));
+            auto const end = offset + sizeof(T);
+            if (entries_.size() == entries_.capacity())
+                entries_.reserve(std::max<size_type>(1, 2 * entries_.capacity()));
+
+            // On growth the value is constructed in the new arena before the
+            // old values are moved, so arguments may refer to stored values.
+            T* object;
+            if (end > capacity_)
+            {
+                auto const capacity = std::max(end, 2 * capacity_);
+                auto const data = static_cast<unsigned char*>(::operator new(capacity));
+                try
+                {
+                    object = ::new(data + offset) T(std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    ::operator delete(data);
+                    throw;
+                }
+                relocate(data, capacity);
+            }
+            else
+            {
+                object = ::new(data_ + offset) T(std::forward<Args>(args)...);
+            }
+            entries_.push_back({&vtable, offset});
+            size_ = end;
+            nontrivial_ += !vtable.trivially_destructible;
+            return *object;
+        }
+
+        /**
+         * Destroys all values. Destructors are not called for values of
+         * trivially destructible types, and the walk over values is skipped
+         * if there is none of the other types. The arena is kept.
+         */
+        void clear() noexcept
+        {
+            if (nontrivial_ > 0)
+            {
+                for (auto const& entry : entries_)
+                {
+                    if (!entry.vtable->trivially_destructible)
+                        entry.vtable->destroy(data_ + entry.offset);
+                }
+            }
+            entries_.clear();
+            size_ = 0;
+            nontrivial_ = 0;
+        }
+
+        //----------------------------------------------------------------------
+        // Element access
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the identifier of the type of the i-th value.
+         */
+        ext::type_id type(size_type i) const noexcept
+        {
+            assert(i < size());
+            return entries_[i].vtable->type;
+        }
+
+        /**
+         * Checks if the i-th value has type T.
+         */
+        template<typename T>
+        bool has_value_of(size_type i) const noexcept
+        {
+            return type(i) == ext::type_id_of<T>();
+        }
+
+        /**
+         * Accesses the i-th value.
+         *
+         * This function does not check the type. Behaviour is undefined if
+         * specified type does not match the type of the value.
+         */
+        template<typename T>
+        T& value(size_type i) noexcept
+        {
+            assert(i < size());
+            return *reinterpret_cast<T*>(data_ + entries_[i].offset);
+        }
+
+        template<typename T>
+        T const& value(size_type i) const noexcept
+        {
+            assert(i < size());
+            return *reinterpret_cast<T const*>(data_ + entries_[i].offset);
+        }
+
+        /**
+         * Calls `fun(value)` for each value of type T in order.
+         */
+        template<typename T, typename F>
+        void for_each(F fun)
+        {
+            auto const type = ext::type_id_of<T>();
+            for (auto const& entry : entries_)
+            {
+                if (entry.vtable->type == type)
+                    fun(*reinterpret_cast<T*>(data_ + entry.offset));
+            }
+        }
+
+        template<typename T, typename F>
+        void for_each(F fun) const
+        {
+            auto const type = ext::type_id_of<T>();
+            for (auto const& entry : entries_)
+            {
+                if (entry.vtable->type == type)
+                    fun(*reinterpret_cast<T const*>(data_ + entry.offset));
+            }
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        struct entry
+        {
+            detail::any_vector_vtable const* vtable;
+            size_type offset;
+        };
+
+        static
+        size_type align_up(size_type offset, size_type alignment) noexcept
+        {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+
+        /*
+         * Moves all values into a new arena. Offsets are kept, which keeps
+         * values aligned since arenas are maximally aligned.
+         */
+        void reallocate(size_type capacity)
+        {
+            relocate(static_cast<unsigned char*>(::operator new(capacity)), capacity);
+        }
+
+        /*
+         * Moves all values into given arena and frees the old one.
+         */
+        void relocate(unsigned char* data, size_type capacity) noexcept
+        {
+            if (size_ > 0)
+            {
+                std::memcpy(data, data_, size_);
+                for (auto const& entry : entries_)
+                {
+                    if (entry.vtable->move)
+                        entry.vtable->move(data_ + entry.offset, data + entry.offset);
+                }
+            }
+            ::operator delete(data_);
+            data_ = data;
+            capacity_ = capacity;
+        }
+
+        std::vector<entry> entries_;
+        unsigned char* data_ = nullptr;
+        size_type size_ = 0;
+        size_type capacity_ = 0;
+        size_type nontrivial_ = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,373 @@
+/*
+ * Binomial distribution implemented with transformed rejection.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_BINOMIAL_DISTRIBUTION_HPP
+#define EXT_BINOMIAL_DISTRIBUTION_HPP
+
+#include <array>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "array_view.hpp"
+
+namespace ext
+{
+    namespace detail
+    {
+        /*
+         * Returns the error of Stirling's approximation of log(k!), i.e.
+         * log(k!) - [(k + 1/2) log(k + 1) - (k + 1) + log(2 pi)/2].
+         */
+        inline
+        double stirling_correction(double k)
+        {
+            static constexpr double table[] = {
+                0.08106146679532726, 0.04134069595540929,
+                0.02767792568499834, 0.02079067210376509,
+                0.01664469118982119, 0.01387612882307075,
+                0.01189670994589177, 0.01041126526197209,
+                0.009255462182712733, 0.008330563433362871
+            };
+
+            if (k < 10)
+                return table[static_cast<std::size_t>(k)];
+
+            double const r = 1 / (k + 1);
+            double const rr = r * r;
+            return (1.0/12 - (1.0/360 - rr / 1260) * rr) * r;
+        }
+    }
+
+    /**
+     * Produces non-negative integers on the binomial distribution.
+     *
+     * Distributions with `t * min(p, 1 - p)` smaller than 10 are sampled by
+     * inversion of a cumulative probability table computed on construction.
+     * Others are sampled with the BTRD transformed rejection algorithm [1],
+     * which takes about two uniform deviates per sample regardless of the
+     * parameters.
+     *
+     * [1]: W. Hörmann, "The generation of binomial random variates", Journal
+     *      of Statistical Computation and Simulation 46 (1993) 101-110.
+     */
+    template<typename IntType = int>
+    struct binomial_distribution
+    {
+        static_assert(std::is_integral<IntType>::value, "invalid result type");
+
+        using result_type = IntType;
+
+      private:
+        static constexpr double inversion_limit = 10;
+        static constexpr std::size_t table_size = 48;
+
+      public:
+        //----------------------------------------------------------------------
+        // Construction
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs the distribution of the number of successes in `t` trials
+         * with success probability `p`.
+         *
+         * Behaviour is undefined if `t` is negative or `p` is out of [0, 1].
+         */
+        explicit
+        binomial_distribution(result_type t = 1, double p = 0.5)
+            : trials_ {t}
+            , prob_ {p}
+        {
+            assert(t >= 0);
+            assert(p >= 0 && p <= 1);
+
+            flipped_ = (p > 0.5);
+            double const q = flipped_ ? 1 - p : p;
+
+            if (double(t) * q < inversion_limit)
+                setup_inversion(q);
+            else
+                setup_btrd(q);
+        }
+
+        //----------------------------------------------------------------------
+        // Characteristics
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the number of trials.
+         */
+        result_type t() const noexcept
+        {
+            return trials_;
+        }
+
+        /**
+         * Returns the success probability of a trial.
+         */
+        double p() const noexcept
+        {
+            return prob_;
+        }
+
+        result_type min() const noexcept
+        {
+            return 0;
+        }
+
+        result_type max() const noexcept
+        {
+            return trials_;
+        }
+
+        /**
+         * Does nothing. The distribution has no internal state.
+         */
+        void reset() noexcept
+        {
+        }
+
+        //----------------------------------------------------------------------
+        // Generation
+        //----------------------------------------------------------------------
+
+        /**
+         * Generates a random number.
+         */
+        template<typename URNG>
+        result_type operator()(URNG& engine) const
+        {
+            auto const k = use_inversion_ ? sample_by_inversion(engine)
+                                          : sample_by_btrd(engine);
+            return flipped_ ? result_type(trials_ - k) : k;
+        }
+
+        /**
+         * Fills the view with random numbers.
+         *
+         * The choice of algorithm is hoisted out of the loop, so this is
+         * faster than calling `operator()` for each element.
+         */
+        template<typename URNG>
+        void fill(URNG& engine, ext::array_view<result_type> output) const
+        {
+            if (use_inversion_)
+            {
+                for (auto& value : output)
+                    value = sample_by_inversion(engine);
+            }
+            else
+            {
+                for (auto& value : output)
+                    value = sample_by_btrd(engine);
+            }
+
+            if (flipped_)
+            {
+                for (auto& value : output)
+                    value = result_type(trials_ - value);
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // Comparison operators
+        //----------------------------------------------------------------------
+
+        friend
+        bool operator==(binomial_distribution const& x,
+                        binomial_distribution const& y) noexcept
+        {
+            return x.trials_ == y.trials_ && x.prob_ == y.prob_;
+        }
+
+        friend
+        bool operator!=(binomial_distribution const& x,
+                        binomial_distribution const& y) noexcept
+        {
+            return !(x == y);
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        template<typename URNG>
+        static double canonical(URNG& engine)
+        {
+            return std::generate_canonical<
+                double, std::numeric_limits<double>::digits>(engine);
+        }
+
+        void setup_inversion(double p)
+        {
+            double const n = double(trials_);
+            double const r = p / (1 - p);
+            double prob = std::pow(1 - p, n);
+            double cum = prob;
+
+            use_inversion_ = true;
+            r_ = r;
+            cdf_[0] = cum;
+            for (std::size_t k = 1; k < table_size; ++k)
+            {
+                prob *= (n - double(k) + 1) / double(k) * r;
+                cum += prob;
+                cdf_[k] = cum;
+            }
+            last_prob_ = prob;
+
+            double const mean = n * p;
+            tail_limit_ = std::fmin(
+                n, std::fmax(double(table_size - 1),
+                             std::ceil(mean + 20 * std::sqrt(mean))));
+        }
+
+        void setup_btrd(double p)
+        {
+            double const n = double(trials_);
+            double const q = 1 - p;
+
+            use_inversion_ = false;
+            m_ = std::floor((n + 1) * p);
+            r_ = p / q;
+            nr_ = (n + 1) * r_;
+            npq_ = n * p * q;
+
+            double const spq = std::sqrt(npq_);
+            b_ = 1.15 + 2.53 * spq;
+            a_ = -0.0873 + 0.0248 * b_ + 0.01 * p;
+            c_ = n * p + 0.5;
+            alpha_ = (2.83 + 5.1 / b_) * spq;
+            vr_ = 0.92 - 4.2 / b_;
+
+            double const nm = n - m_ + 1;
+            h_ = (m_ + 0.5) * std::log((m_ + 1) / (r_ * nm))
+                 + detail::stirling_correction(m_)
+                 + detail::stirling_correction(n - m_);
+        }
+
+        template<typename URNG>
+        result_type sample_by_inversion(URNG& engine) const
+        {
+            double const n = double(trials_);
+
+            for (;;)
+            {
+                double const u = canonical(engine);
+
+                for (std::size_t k = 0; k < table_size; ++k)
+                {
+                    if (u < cdf_[k])
+                        return result_type(std::fmin(double(k), n));
+                }
+
+                // Extremely rare: continue the recurrence beyond the table.
+                double k = table_size - 1;
+                double prob = last_prob_;
+                double cum = cdf_[table_size - 1];
+                while (u >= cum && k < tail_limit_)
+                {
+                    k += 1;
+                    prob *= (n - k + 1) / k * r_;
+                    cum += prob;
+                }
+                if (u < cum)
+                    return result_type(k);
+
+                // u is beyond the rounded total probability.
+            }
+        }
+
+        template<typename URNG>
+        result_type sample_by_btrd(URNG& engine) const
+        {
+            double const n = double(trials_);
+
+            for (;;)
+            {
+                double const u = canonical(engine) - 0.5;
+                double v = canonical(engine);
+                double const us = 0.5 - std::fabs(u);
+                double const k = std::floor((2 * a_ / us + b_) * u + c_);
+
+                if (k < 0 || k > n)
+                    continue;
+
+                if (us >= 0.07 && v <= vr_) // taken about 80% of times
+                    return result_type(k);
+
+                v *= alpha_ / (a_ / (us * us) + b_);
+
+                // Recursive evaluation of f(k)/f(m) near the mode.
+                double const km = std::fabs(k - m_);
+                if (km <= 15)
+                {
+                    double f = 1;
+                    if (m_ < k)
+                    {
+                        for (double i = m_ + 1; i <= k; i += 1)
+                            f *= nr_ / i - r_;
+                    }
+                    else
+                    {
+                        for (double i = k + 1; i <= m_; i += 1)
+                            v *= nr_ / i - r_;
+                    }
+                    if (v <= f)
+                        return result_type(k);
+                    continue;
+                }
+
+                // Squeeze with the normal approximation.
+                v = std::log(v);
+                double const rho = (km / npq_)
+                    * (((km / 3 + 0.625) * km + 1.0 / 6) / npq_ + 0.5);
+                double const t = -km * km / (2 * npq_);
+                if (v < t - rho)
+                    return result_type(k);
+                if (v > t + rho)
+                    continue;
+
+                // Final acceptance test with Stirling's formula.
+                double const nm = n - m_ + 1;
+                double const nk = n - k + 1;
+                double const bound = h_
+                    + (n + 1) * std::log(nm / nk)
+                    + (k + 0.5) * std::log(nk * r_ / (k + 1))
+                    - detail::stirling_correction(k)
+                    - detail::stirling_correction(n - k);
+                if (v <= bound)
+                    return result_type(k);
+            }
+        }
+
+        result_type trials_;
+        double prob_;
+        bool flipped_ = false;
+        bool use_inversion_ = false;
+        double r_ = 0;
+
+        // Inversion
+        std::array<double, table_size> cdf_ {{}};
+        double last_prob_ = 0;
+        double tail_limit_ = 0;
+
+        // BTRD
+        double m_ = 0;
+        double nr_ = 0;
+        double npq_ = 0;
+        double a_ = 0;
+        double b_ = 0;
+        double c_ = 0;
+        double alpha_ = 0;
+        double vr_ = 0;
+        double h_ = 0;
+    };
+}
+
+#endif
@@ -30,6 +30,52 @@ namespace ext
         else
             return T(T(x << n) | T(x >> (bits - n)));
     }
+
+    /**
+     * Counts the number of consecutive zero bits from the least significant
+     * bit.
+     *
+     * Behaviour is undefined if `x` is zero.
+     */
+    template<typename T,
+             std::enable_if_t<std::is_unsigned<T>::value, int> = 0>
+    constexpr
+    unsigned count_trailing_zeros(T x)
+    {
+#if defined(__GNUC__)
+        if (sizeof(T) <= sizeof(unsigned))
+            return unsigned(__builtin_ctz(x));
+        else
+            return unsigned(__builtin_ctzll(x));
+#else
+        unsigned count = 0;
+        for (; (x & 1u) == 0; x = T(x >> 1))
+            ++count;
+        return count;
+#endif
+    }
+
+    /**
+     * Reverses the order of bits.
+     *
+     * Swaps halves, then quarters, and so on, taking log2 of the bit width
+     * steps. The bit width must be a power of two.
+     */
+    template<typename T,
+             std::enable_if_t<std::is_unsigned<T>::value, int> = 0>
+    constexpr
+    T reverse_bits(T x)
+    {
+        constexpr auto bits = std::numeric_limits<T>::digits;
+
+        T mask = T(~T(0));
+        for (auto shift = bits / 2; shift > 0; shift /= 2)
+        {
+            mask = T(mask ^ T(mask << shift));
+            x = T(T(T(x >> shift) & mask) | T(T(x << shift) & T(~mask)));
+        }
+        return x;
+    }
 }
 
 #endif
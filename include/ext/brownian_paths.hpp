@@ -0,0 +1,364 @@
+/*
+ * Batch generation of Brownian motion paths.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_BROWNIAN_PATHS_HPP
+#define EXT_BROWNIAN_PATHS_HPP
+
+#include <vector>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "array_view.hpp"
+#include "ziggurat_normal_distribution.hpp"
+
+namespace ext
+{
+    /**
+     * Generates discretely sampled paths of the standard Brownian motion.
+     *
+     * A path is the sequence W(dt), W(2 dt), ..., W(n dt) where n is the
+     * number of steps. W(0) = 0 is not stored. Paths are generated by
+     * drawing normal increments with the ziggurat algorithm for a whole path
+     * at once and then summing them up in place.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::brownian_paths<double> brownian {252, 1.0 / 252};
+     *
+     * std::vector<double> paths(10000 * brownian.steps());
+     * brownian.fill(engine, paths);
+     * ```
+     */
+    template<typename T = double>
+    struct brownian_paths
+    {
+        using result_type = T;
+        using size_type = std::size_t;
+
+        //----------------------------------------------------------------------
+        // Construction
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs a generator of paths with specified number of steps and
+         * time step.
+         *
+         * Behaviour is undefined if `steps` is zero or `dt` is not positive.
+         */
+        brownian_paths(size_type steps, result_type dt)
+            : steps_ {steps}
+            , dt_ {dt}
+            , scale_ {std::sqrt(dt)}
+        {
+            assert(steps > 0);
+            assert(dt > 0);
+        }
+
+        //----------------------------------------------------------------------
+        // Characteristics
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the number of steps in a path.
+         */
+        size_type steps() const noexcept
+        {
+            return steps_;
+        }
+
+        /**
+         * Returns the time step.
+         */
+        result_type dt() const noexcept
+        {
+            return dt_;
+        }
+
+        //----------------------------------------------------------------------
+        // Generation
+        //----------------------------------------------------------------------
+
+        /**
+         * Fills the view with random paths.
+         *
+         * The view is treated as a paths-by-steps matrix in row-major order
+         * and each row receives a path.
+         *
+         * Behaviour is undefined if the size of `paths` is not a multiple of
+         * `steps()`.
+         */
+        template<typename URNG>
+        void fill(URNG& engine, ext::array_view<result_type> paths)
+        {
+            assert(paths.size() % steps_ == 0);
+
+            for (size_type start = 0; start < paths.size(); start += steps_)
+            {
+                auto const path = paths.slice(start, start + steps_);
+                normal_.fill(engine, path);
+                integrate(path);
+            }
+        }
+
+        /**
+         * Fills the view with antithetic pairs of random paths.
+         *
+         * Rows are paired as (0, 1), (2, 3), and so on. The second path of a
+         * pair is the negation of the first one, so only half the normal
+         * values are drawn.
+         *
+         * Behaviour is undefined if the size of `paths` is not a multiple of
+         * twice `steps()`.
+         */
+        template<typename URNG>
+        void fill_antithetic(URNG& engine, ext::array_view<result_type> paths)
+        {
+            assert(paths.size() % (2 * steps_) == 0);
+
+            for (size_type start = 0; start < paths.size(); start += 2 * steps_)
+            {
+                auto const path = paths.slice(start, start + steps_);
+                auto const mirror = paths.slice(start + steps_, start + 2 * steps_);
+                normal_.fill(engine, path);
+
+                result_type sum = 0;
+                for (size_type i = 0; i < steps_; ++i)
+                {
+                    sum += scale_ * path[i];
+                    path[i] = sum;
+                    mirror[i] = -sum;
+                }
+            }
+        }
+
+        /**
+         * Transforms rows of standard normal values into paths in place.
+         *
+         * Use this to build paths from normal values obtained elsewhere.
+         *
+         * Behaviour is undefined if the size of `paths` is not a multiple of
+         * `steps()`.
+         */
+        void transform(ext::array_view<result_type> paths) const
+        {
+            assert(paths.size() % steps_ == 0);
+
+            for (size_type start = 0; start < paths.size(); start += steps_)
+                integrate(paths.slice(start, start + steps_));
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        void integrate(ext::array_view<result_type> path) const
+        {
+            result_type sum = 0;
+            for (auto& value : path)
+            {
+                sum += scale_ * value;
+                value = sum;
+            }
+        }
+
+        size_type steps_;
+        result_type dt_;
+        result_type scale_;
+        ext::ziggurat_normal_distribution<result_type> normal_;
+    };
+
+    /**
+     * Constructs paths of the standard Brownian motion by the Brownian bridge
+     * construction.
+     *
+     * The first normal value determines the end point of the path, the
+     * second one the middle point conditional on the end, and so on with
+     * bisection. Most of the variance of the path is thus carried by the
+     * first few values. This makes quasi-random points, whose leading
+     * coordinates are the most uniform, effective for path-dependent
+     * integrands.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::brownian_bridge<double> bridge {64, 1.0 / 64};
+     * ext::sobol_engine sobol {bridge.steps()};
+     *
+     * std::vector<double> paths(1024 * bridge.steps());
+     * sobol.fill(paths);
+     * for (auto& value : paths)
+     *     value = ext::normal_quantile(value);
+     * bridge.transform(paths);
+     * ```
+     */
+    template<typename T = double>
+    struct brownian_bridge
+    {
+        using result_type = T;
+        using size_type = std::size_t;
+
+        //----------------------------------------------------------------------
+        // Construction
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs the bridge for paths with specified number of steps and
+         * time step.
+         *
+         * Behaviour is undefined if `steps` is zero or `dt` is not positive.
+         */
+        brownian_bridge(size_type steps, result_type dt)
+            : steps_ {steps}
+            , dt_ {dt}
+            , nodes_(steps)
+        {
+            assert(steps > 0);
+            assert(dt > 0);
+            build();
+        }
+
+        //----------------------------------------------------------------------
+        // Characteristics
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the number of steps in a path.
+         */
+        size_type steps() const noexcept
+        {
+            return steps_;
+        }
+
+        /**
+         * Returns the time step.
+         */
+        result_type dt() const noexcept
+        {
+            return dt_;
+        }
+
+        //----------------------------------------------------------------------
+        // Construction of paths
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs a path from standard normal values.
+         *
+         * Behaviour is undefined if the sizes of the views are not equal to
+         * `steps()`.
+         */
+        void operator()(ext::array_view<result_type const> normals,
+                        ext::array_view<result_type> path) const
+        {
+            assert(normals.size() == steps_);
+            assert(path.size() == steps_);
+
+            path[steps_ - 1] = nodes_[0].stddev * normals[0];
+
+            for (size_type i = 1; i < steps_; ++i)
+            {
+                auto const& node = nodes_[i];
+                result_type const left = node.left == 0 ? 0 : path[node.left - 1];
+                path[node.index] = node.left_weight * left
+                                   + node.right_weight * path[node.right]
+                                   + node.stddev * normals[i];
+            }
+        }
+
+        /**
+         * Transforms rows of standard normal values into paths in place.
+         *
+         * The view is treated as a paths-by-steps matrix in row-major order.
+         *
+         * Behaviour is undefined if the size of `paths` is not a multiple of
+         * `steps()`.
+         */
+        void transform(ext::array_view<result_type> paths) const
+        {
+            assert(paths.size() % steps_ == 0);
+
+            std::vector<result_type> normals(steps_);
+            for (size_type start = 0; start < paths.size(); start += steps_)
+            {
+                auto const path = paths.slice(start, start + steps_);
+                normals.assign(path.begin(), path.end());
+                (*this)(normals, path);
+            }
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        /*
+         * A point on the path determined by interpolating the points at left
+         * and right with Gaussian noise. Indices point into the path; left is
+         * off by one so that zero denotes W(0) = 0.
+         */
+        struct node
+        {
+            size_type index = 0;
+            size_type left = 0;
+            size_type right = 0;
+            result_type left_weight = 0;
+            result_type right_weight = 0;
+            result_type stddev = 0;
+        };
+
+        /*
+         * Computes the construction order by repeatedly bisecting the first
+         * undetermined run of points.
+         */
+        void build()
+        {
+            auto const time = [&](size_type i) {
+                return dt_ * result_type(i);
+            };
+
+            std::vector<bool> determined(steps_);
+            determined[steps_ - 1] = true;
+            nodes_[0].index = steps_ - 1;
+            nodes_[0].stddev = std::sqrt(time(steps_));
+
+            size_type j = 0;
+            for (size_type i = 1; i < steps_; ++i)
+            {
+                while (determined[j])
+                    ++j;
+                size_type k = j;
+                while (!determined[k])
+                    ++k;
+
+                // Run of undetermined points [j, k) between determined points
+                // j - 1 (or the origin) and k. Times are one-based.
+                size_type const l = j + (k - 1 - j) / 2;
+                determined[l] = true;
+
+                auto const t_left = time(j);
+                auto const t_mid = time(l + 1);
+                auto const t_right = time(k + 1);
+
+                auto& node = nodes_[i];
+                node.index = l;
+                node.left = j;
+                node.right = k;
+                node.left_weight = (t_right - t_mid) / (t_right - t_left);
+                node.right_weight = (t_mid - t_left) / (t_right - t_left);
+                node.stddev = std::sqrt((t_mid - t_left) * (t_right - t_mid)
+                                        / (t_right - t_left));
+
+                j = k + 1;
+                if (j >= steps_)
+                    j = 0;
+            }
+        }
+
+        size_type steps_;
+        result_type dt_;
+        std::vector<node> nodes_;
+    };
+}
+
+#endif
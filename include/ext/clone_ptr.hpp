@@ -8,11 +8,81 @@
 #define EXT_CLONE_PTR_HPP
 
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 #include <cassert>
+#include <cstddef>
 
 namespace ext
 {
+    namespace detail
+    {
+        template<typename T,
+                 typename = decltype(std::declval<T const&>().clone())>
+        std::true_type probe_clone_member(int);
+
+        template<typename T>
+        std::false_type probe_clone_member(...);
+
+        /*
+         * True if the copy constructor makes an exact copy: either T is
+         * polymorphic and final, so that the dynamic type of every object of
+         * type T is T itself, or T is not polymorphic and does not define
+         * its own copy as a `clone()` member.
+         */
+        template<typename T>
+        struct is_statically_cloneable : std::integral_constant<bool,
+            std::is_copy_constructible<T>::value &&
+            (std::is_polymorphic<T>::value
+                ? std::is_final<T>::value
+                : !decltype(detail::probe_clone_member<T>(0))::value)>
+        {
+        };
+
+        /*
+         * Takes the ownership of a copy of an object of type T returned by
+         * `clone()` as a pointer to T, to a class derived from T, or to a
+         * polymorphic base of T. In the last case the copy is checked to be
+         * a T where RTTI is available.
+         */
+        template<typename T, typename U>
+        std::unique_ptr<T> adopt_clone(std::unique_ptr<U> copy)
+        {
+            static_assert(std::is_base_of<T, U>::value ||
+                          (std::is_base_of<U, T>::value &&
+                           std::is_polymorphic<U>::value),
+                          "clone() must return std::unique_ptr to T, to a "
+                          "class derived from T, or to a polymorphic base of T");
+
+            assert(static_cast<bool>(copy));
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
+            assert(dynamic_cast<T*>(copy.get()));
+#endif
+            return std::unique_ptr<T> {static_cast<T*>(copy.release())};
+        }
+    }
+
+    /**
+     * Opt-in trait for polymorphic types that can clone objects into storage
+     * provided by the caller.
+     *
+     * Specialize this to derive from `std::true_type` for a type T that
+     * provides the following const member functions:
+     *
+     * - `std::size_t clone_size()` returning the size of the dynamic type,
+     * - `std::size_t clone_alignment()` returning its alignment, and
+     * - `T* clone_into(void* storage)` constructing a copy in given storage
+     *   of that size and alignment.
+     *
+     * Final polymorphic types and non-polymorphic types without a `clone()`
+     * member need no opt-in if they are copy constructible.
+     */
+    template<typename T>
+    struct enable_placement_clone : std::false_type
+    {
+    };
+
     /**
      * Customizable traits class for cloning polymorphic object whose dynamic
      * type is derived from type `T`.
@@ -20,12 +90,25 @@ namespace ext
     template<typename T>
     struct clone_traits
     {
+        /**
+         * True if `clone_size`, `clone_alignment` and `clone_into` can be
+         * used.
+         */
+        static constexpr bool supports_placement =
+            detail::is_statically_cloneable<T>::value ||
+            ext::enable_placement_clone<T>::value;
+
         /**
          * Creates a copy of the given object using its dynamic type.
          *
-         * This default implementation assumes the existence of `T::clone()`
-         * member function and uses it to create a copy, or compile fails.
-         * Assertion fails if that function returns a null pointer.
+         * If T is polymorphic and final, or not polymorphic and without a
+         * `clone()` member, and copy constructible, the copy is made by the
+         * copy constructor without a virtual call. Otherwise this default
+         * implementation uses `T::clone()` member function, which must
+         * return `std::unique_ptr` with the default deleter to T, to a class
+         * derived from T, or to a polymorphic base of T. Assertion fails if
+         * that function returns a null pointer, or, where RTTI is available,
+         * a copy that is not a T.
          *
          * @param object
          *      A reference to the object to make a copy of.
@@ -36,12 +119,96 @@ namespace ext
         static
         std::unique_ptr<T> clone(T const& object)
         {
-            std::unique_ptr<T> copy = object.clone();
-            assert(static_cast<bool>(copy));
+            return clone(object, detail::is_statically_cloneable<T> {});
+        }
+
+        /**
+         * Returns the size of the storage needed by `clone_into`.
+         */
+        static
+        std::size_t clone_size(T const& object) noexcept
+        {
+            static_assert(supports_placement, "placement clone is not enabled");
+            return clone_size(object, detail::is_statically_cloneable<T> {});
+        }
+
+        /**
+         * Returns the alignment of the storage needed by `clone_into`.
+         */
+        static
+        std::size_t clone_alignment(T const& object) noexcept
+        {
+            static_assert(supports_placement, "placement clone is not enabled");
+            return clone_alignment(object, detail::is_statically_cloneable<T> {});
+        }
+
+        /**
+         * Creates a copy of the given object in given storage, which must
+         * have the size and alignment returned by `clone_size` and
+         * `clone_alignment`. The caller destroys the copy.
+         */
+        static
+        T* clone_into(T const& object, void* storage)
+        {
+            static_assert(supports_placement, "placement clone is not enabled");
+            return clone_into(object, storage, detail::is_statically_cloneable<T> {});
+        }
+
+      private:
+        static
+        std::unique_ptr<T> clone(T const& object, std::true_type)
+        {
+            return std::make_unique<T>(object);
+        }
+
+        static
+        std::unique_ptr<T> clone(T const& object, std::false_type)
+        {
+            return detail::adopt_clone<T>(object.clone());
+        }
+
+        static
+        std::size_t clone_size(T const&, std::true_type) noexcept
+        {
+            return sizeof(T);
+        }
+
+        static
+        std::size_t clone_size(T const& object, std::false_type) noexcept
+        {
+            return object.clone_size();
+        }
+
+        static
+        std::size_t clone_alignment(T const&, std::true_type) noexcept
+        {
+            return alignof(T);
+        }
+
+        static
+        std::size_t clone_alignment(T const& object, std::false_type) noexcept
+        {
+            return object.clone_alignment();
+        }
+
+        static
+        T* clone_into(T const& object, void* storage, std::true_type)
+        {
+            return ::new(storage) T(object);
+        }
+
+        static
+        T* clone_into(T const& object, void* storage, std::false_type)
+        {
+            T* const copy = object.clone_into(storage);
+            assert(copy);
             return copy;
         }
     };
 
+    template<typename T>
+    constexpr bool clone_traits<T>::supports_placement;
+
     /**
      * Smart pointer with value semantics using polymorphic clone function.
      */
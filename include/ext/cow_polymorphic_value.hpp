@@ -0,0 +1,404 @@
+/*
+ * Runtime polymorphism with copy-on-write value semantics.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_COW_POLYMORPHIC_VALUE_HPP
+#define EXT_COW_POLYMORPHIC_VALUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <cassert>
+
+#include "memory_resource.hpp"
+
+namespace ext
+{
+    namespace detail
+    {
+        template<typename T>
+        struct cow_control;
+
+        /*
+         * Functions operating on a shared block, one table per type. `base`
+         * returns the base subobject of the object.
+         */
+        template<typename T>
+        struct cow_vtable
+        {
+            T* (*base)(cow_control<T>* control) noexcept;
+            cow_control<T>* (*copy)(cow_control<T> const& source);
+            void (*destroy)(cow_control<T>* control) noexcept;
+        };
+
+        /*
+         * Header of a shared block, which is followed by the object.
+         */
+        template<typename T>
+        struct cow_control
+        {
+            cow_vtable<T> const* vtable;
+            ext::memory_resource* resource;
+            std::atomic<long> refs;
+        };
+
+        template<typename S, typename T>
+        struct cow_vtable_of;
+
+        template<typename S, typename T>
+        struct cow_block : cow_control<T>
+        {
+            S value;
+
+            template<typename... Args>
+            explicit
+            cow_block(ext::memory_resource* res, Args&&... args)
+                : cow_control<T> {&cow_vtable_of<S, T>::value, res, {1}}
+                , value(std::forward<Args>(args)...)
+            {
+            }
+        };
+
+        template<typename S, typename T>
+        struct cow_handler
+        {
+            using control = cow_control<T>;
+            using block = cow_block<S, T>;
+
+            template<typename... Args>
+            static control* create(ext::memory_resource* resource,
+                                   Args&&... args)
+            {
+                return ext::new_object<block>(
+                    resource, resource, std::forward<Args>(args)...);
+            }
+
+            static T* base(control* ctrl) noexcept
+            {
+                return &static_cast<block*>(ctrl)->value;
+            }
+
+            static control* copy(control const& source)
+            {
+                auto const& src = static_cast<block const&>(source);
+                return create(src.resource, src.value);
+            }
+
+            static void destroy(control* ctrl) noexcept
+            {
+                auto const ptr = static_cast<block*>(ctrl);
+                ext::delete_object(ptr->resource, ptr);
+            }
+        };
+
+        template<typename S, typename T>
+        struct cow_vtable_of
+        {
+            using handler = cow_handler<S, T>;
+
+            static constexpr cow_vtable<T> value = {
+                handler::base,
+                handler::copy,
+                handler::destroy
+            };
+        };
+
+        template<typename S, typename T>
+        constexpr cow_vtable<T> cow_vtable_of<S, T>::value;
+    }
+
+    /**
+     * Holds polymorphic object with value semantics, sharing the object
+     * among copies until one of them is modified.
+     *
+     * Copying only increments an atomic reference count. The first
+     * non-const access through a copy whose object is shared clones the
+     * object, so copies behave as independent values. Read through const
+     * references to avoid the clone. A mutable reference obtained from a
+     * copy must not be used after the copy is copied again.
+     *
+     * The object is allocated from a memory resource, which is
+     * `ext::new_delete_resource()` unless specified otherwise. Clones and
+     * replacement contents allocate from the same resource.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::cow_polymorphic_value<config_node> snapshot = live_tree;
+     * render(snapshot);         // const access, no clone
+     * snapshot->set_value(42);  // clones the shared node
+     * ```
+     */
+    template<typename T>
+    struct cow_polymorphic_value
+    {
+        //----------------------------------------------------------------------
+        // Constructors
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs an object with specified content.
+         */
+        template<typename S,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<S>, cow_polymorphic_value>::value,
+                     int> = 0>
+        cow_polymorphic_value(S&& value)
+            : cow_polymorphic_value {std::allocator_arg,
+                                     ext::new_delete_resource(),
+                                     std::forward<S>(value)}
+        {
+        }
+
+        /**
+         * Constructs an object with specified content allocated from given
+         * resource. The resource must outlive all copies.
+         */
+        template<typename S,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<S>, cow_polymorphic_value>::value,
+                     int> = 0>
+        cow_polymorphic_value(std::allocator_arg_t,
+                              ext::memory_resource* resource,
+                              S&& value)
+            : control_ {create<std::decay_t<S>>(resource, std::forward<S>(value))}
+        {
+        }
+
+        //----------------------------------------------------------------------
+        // Special member functions
+        //----------------------------------------------------------------------
+
+        /**
+         * Shares the content of other.
+         */
+        cow_polymorphic_value(cow_polymorphic_value const& other) noexcept
+            : control_ {other.control_}
+        {
+            assert(control_);
+            control_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Moves content of other into a new instance.
+         */
+        cow_polymorphic_value(cow_polymorphic_value&& other) noexcept
+            : control_ {other.control_}
+        {
+            other.control_ = nullptr;
+        }
+
+        /**
+         * Shares the content of other, releasing old one.
+         */
+        cow_polymorphic_value& operator=(cow_polymorphic_value const& other) noexcept
+        {
+            cow_polymorphic_value {other}.swap(*this);
+            return *this;
+        }
+
+        /**
+         * Moves content of other into object, releasing old one.
+         */
+        cow_polymorphic_value& operator=(cow_polymorphic_value&& other) noexcept
+        {
+            cow_polymorphic_value {std::move(other)}.swap(*this);
+            return *this;
+        }
+
+        /**
+         * Releases the content, destroying it if this is the last owner.
+         */
+        ~cow_polymorphic_value()
+        {
+            release();
+        }
+
+        //----------------------------------------------------------------------
+        // Modifiers
+        //----------------------------------------------------------------------
+
+        /**
+         * Replaces the content with the right-hand side, allocated from the
+         * resource of the old content.
+         */
+        template<typename S,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<S>, cow_polymorphic_value>::value,
+                     int> = 0>
+        cow_polymorphic_value& operator=(S&& value)
+        {
+            emplace<std::decay_t<S>>(std::forward<S>(value));
+            return *this;
+        }
+
+        /**
+         * Replaces the content with newly constructed object, allocated from
+         * the resource of the old content, or `ext::new_delete_resource()`
+         * if this object is moved out.
+         */
+        template<typename S, typename... Args>
+        void emplace(Args&&... args)
+        {
+            auto const resource = control_ ? control_->resource
+                                           : ext::new_delete_resource();
+            auto const control = create<S>(resource, std::forward<Args>(args)...);
+            release();
+            control_ = control;
+        }
+
+        /**
+         * Swaps contents.
+         */
+        void swap(cow_polymorphic_value& other) noexcept
+        {
+            std::swap(control_, other.control_);
+        }
+
+        //----------------------------------------------------------------------
+        // Observers
+        //----------------------------------------------------------------------
+
+        /**
+         * Accesses contained object. The non-const overload clones the
+         * object first if it is shared.
+         *
+         * Behaviour is undefined if this member function is called on moved-out
+         * object.
+         */
+        T& value()
+        {
+            detach();
+            return *get();
+        }
+
+        T const& value() const noexcept
+        {
+            return *get();
+        }
+
+        /**
+         * Accesses contained object as type S. The non-const overload clones
+         * the object first if it is shared.
+         *
+         * This function does not check the dynamic type. Behaviour is undefined
+         * if the dynamic type of the contained object is not `S` or a subclass
+         * of `S`.
+         *
+         * Behaviour is undefined if this member function is called on moved-out
+         * object.
+         */
+        template<typename S>
+        S& as()
+        {
+            return static_cast<S&>(value());
+        }
+
+        template<typename S>
+        S const& as() const
+        {
+            return static_cast<S const&>(value());
+        }
+
+        /**
+         * Accesses member of contained object. The non-const overload clones
+         * the object first if it is shared.
+         *
+         * Behaviour is undefined if this member function is called on moved-out
+         * object.
+         */
+        T* operator->()
+        {
+            return &value();
+        }
+
+        T const* operator->() const noexcept
+        {
+            return get();
+        }
+
+        /**
+         * Returns the number of objects sharing the content. The result is
+         * approximate if other threads copy or release the content.
+         */
+        long use_count() const noexcept
+        {
+            return control_ ? control_->refs.load(std::memory_order_relaxed) : 0;
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        using control_type = detail::cow_control<T>;
+
+        template<typename S, typename... Args>
+        static control_type* create(ext::memory_resource* resource,
+                                    Args&&... args)
+        {
+            static_assert(std::is_copy_constructible<S>::value,
+                          "contained type must be copy constructible");
+            static_assert(std::is_base_of<T, S>::value,
+                          "contained type must be derived from the base type");
+
+            return detail::cow_handler<S, T>::create(
+                resource, std::forward<Args>(args)...);
+        }
+
+        T* get() const noexcept
+        {
+            return control_->vtable->base(control_);
+        }
+
+        /*
+         * Makes this the only owner of the content, cloning it if shared.
+         * The acquire load pairs with the release decrement of other owners
+         * so that their accesses happen before our writes.
+         */
+        void detach()
+        {
+            if (control_->refs.load(std::memory_order_acquire) != 1)
+            {
+                auto const copy = control_->vtable->copy(*control_);
+                release();
+                control_ = copy;
+            }
+        }
+
+        void release() noexcept
+        {
+            if (control_ &&
+                control_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                control_->vtable->destroy(control_);
+            }
+            control_ = nullptr;
+        }
+
+        control_type* control_;
+    };
+
+    /**
+     * Compares contained values.
+     *
+     * Comparison is done by `operator==` overloaded for the base type `T`, not
+     * the dynamic type of the contents of the operands.
+     */
+    template<typename T>
+    bool operator==(ext::cow_polymorphic_value<T> const& a,
+                    ext::cow_polymorphic_value<T> const& b)
+    {
+        return a.value() == b.value();
+    }
+
+    template<typename T>
+    bool operator!=(ext::cow_polymorphic_value<T> const& a,
+                    ext::cow_polymorphic_value<T> const& b)
+    {
+        return !(a == b);
+    }
+}
+
+#endif
@@ -0,0 +1,431 @@
+/*
+ * Structure-of-arrays storage for many random number engines.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_ENGINE_ARRAY_HPP
+#define EXT_ENGINE_ARRAY_HPP
+
+#include <type_traits>
+#include <vector>
+
+#include <cassert>
+#include <cstddef>
+
+#include "array_view.hpp"
+#include "bit_utility.hpp"
+#include "random_utility.hpp"
+#include "small_fast_counting_engine_v4.hpp"
+
+namespace ext
+{
+    /**
+     * Array of random number engines stored as a structure of arrays.
+     *
+     * Only instantiations of `ext::small_fast_counting_engine_v4` are
+     * supported.
+     */
+    template<typename Engine>
+    struct engine_array;
+
+    /**
+     * Array of small fast counting engines.
+     *
+     * The a, b, c, and counter words of the engines are stored in four
+     * contiguous columns, so stepping every engine at once is a loop over
+     * plain arrays that compilers vectorize. This suits simulations where
+     * each of many agents owns an independent stream. Engines are accessed
+     * individually through `operator[]`, which returns a reference usable as
+     * a uniform random bit generator.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::seed_seq_fe<4> seed {run_id};
+     * ext::engine_array<ext::sfc32> engines {agents.size(), seed};
+     *
+     * std::vector<std::uint32_t> draws(engines.size());
+     * engines.generate(draws);
+     *
+     * std::uniform_int_distribution<int> dice {1, 6};
+     * auto engine = engines[42];
+     * auto const roll = dice(engine);
+     * ```
+     */
+    template<typename Word,
+             unsigned BarrelShift,
+             unsigned RightShift,
+             unsigned LeftShift,
+             unsigned long long InitialRound>
+    struct engine_array<ext::small_fast_counting_engine_v4<
+            Word, BarrelShift, RightShift, LeftShift, InitialRound>>
+    {
+        using engine_type = ext::small_fast_counting_engine_v4<
+            Word, BarrelShift, RightShift, LeftShift, InitialRound>;
+        using result_type = typename engine_type::result_type;
+        using size_type = std::size_t;
+
+        /**
+         * Reference to an engine in the array.
+         *
+         * The reference satisfies the requirements of uniform random bit
+         * generator, and generates the same values as the referenced engine
+         * would.
+         */
+        struct reference
+        {
+            using result_type = typename engine_type::result_type;
+
+            static constexpr
+            result_type min() noexcept
+            {
+                return engine_type::min();
+            }
+
+            static constexpr
+            result_type max() noexcept
+            {
+                return engine_type::max();
+            }
+
+            /**
+             * Advances the referenced engine and returns a pseudo-random
+             * value.
+             */
+            result_type operator()() noexcept
+            {
+                return array_->step(index_);
+            }
+
+            /**
+             * Advances the referenced engine z times.
+             */
+            void discard(unsigned long long z) noexcept
+            {
+                for (; z != 0; --z)
+                    array_->step(index_);
+            }
+
+            /**
+             * Returns a copy of the referenced engine.
+             */
+            operator engine_type() const noexcept
+            {
+                return array_->get(index_);
+            }
+
+            /**
+             * Replaces the referenced engine with a copy of given one.
+             */
+            reference& operator=(engine_type const& engine) noexcept
+            {
+                array_->set(index_, engine);
+                return *this;
+            }
+
+          private:
+            friend struct engine_array;
+
+            reference(engine_array* array, size_type index) noexcept
+                : array_ {array}
+                , index_ {index}
+            {
+            }
+
+            engine_array* array_;
+            size_type index_;
+        };
+
+        //----------------------------------------------------------------------
+        // Construction and seeding
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs an empty array.
+         */
+        engine_array() = default;
+
+        /**
+         * Constructs an array of n engines, each equal to
+         * `engine_type(seed_val)`.
+         */
+        explicit
+        engine_array(size_type n,
+                     result_type seed_val = engine_type::default_seed)
+            : state_a_(n, seed_val)
+            , state_b_(n, seed_val)
+            , state_c_(n, seed_val)
+            , counter_(n, 1)
+        {
+            discard(engine_type::initial_round);
+        }
+
+        /**
+         * Constructs an array of n engines whose states are initialized using
+         * seed values generated by given seed sequence.
+         *
+         * The state is seeded as if by a single call to `ext::seed_state` on
+         * an array of 3n words, so the engines differ from those constructed
+         * one by one from the same seed sequence. Seed values are generated
+         * in fixed-size chunks directly into the engines.
+         */
+        template<typename Seed,
+                 std::enable_if_t<ext::is_seed_sequence<Seed>::value, int> = 0>
+        engine_array(size_type n, Seed& seed_seq)
+            : state_a_(n)
+            , state_b_(n)
+            , state_c_(n)
+            , counter_(n, 1)
+        {
+            // Words arrive in order, interleaved as a, b, c for each engine.
+            result_type* const columns[] = {
+                state_a_.data(), state_b_.data(), state_c_.data()
+            };
+            size_type row = 0;
+            unsigned column = 0;
+
+            detail::generate_seed_words<result_type>(
+                seed_seq, 3 * n,
+                [&](std::size_t, ext::array_view<result_type const> words) {
+                    for (auto const word : words)
+                    {
+                        columns[column][row] = word;
+                        if (++column == 3)
+                        {
+                            column = 0;
+                            ++row;
+                        }
+                    }
+                });
+
+            discard(engine_type::initial_round);
+        }
+
+        /**
+         * Initializes the i-th engine as `engine_type(seed_val)`.
+         */
+        void seed(size_type i, result_type seed_val = engine_type::default_seed)
+        {
+            set(i, engine_type {seed_val});
+        }
+
+        /**
+         * Initializes the i-th engine as `engine_type(seed_seq)`.
+         */
+        template<typename Seed,
+                 std::enable_if_t<ext::is_seed_sequence<Seed>::value, int> = 0>
+        void seed(size_type i, Seed& seed_seq)
+        {
+            set(i, engine_type {seed_seq});
+        }
+
+        //----------------------------------------------------------------------
+        // Access
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the number of engines.
+         */
+        size_type size() const noexcept
+        {
+            return counter_.size();
+        }
+
+        /**
+         * Returns a reference to the i-th engine.
+         *
+         * Behaviour is undefined if i is not less than `size()`.
+         */
+        reference operator[](size_type i) noexcept
+        {
+            assert(i < size());
+            return reference {this, i};
+        }
+
+        /**
+         * Returns a copy of the i-th engine.
+         */
+        engine_type get(size_type i) const noexcept
+        {
+            assert(i < size());
+
+            engine_type engine;
+            engine.state_a_ = state_a_[i];
+            engine.state_b_ = state_b_[i];
+            engine.state_c_ = state_c_[i];
+            engine.counter_ = counter_[i];
+            return engine;
+        }
+
+        /**
+         * Replaces the i-th engine with a copy of given one.
+         */
+        void set(size_type i, engine_type const& engine) noexcept
+        {
+            assert(i < size());
+
+            state_a_[i] = engine.state_a_;
+            state_b_[i] = engine.state_b_;
+            state_c_[i] = engine.state_c_;
+            counter_[i] = engine.counter_;
+        }
+
+        //----------------------------------------------------------------------
+        // Random number generation
+        //----------------------------------------------------------------------
+
+        /**
+         * Advances every engine once, storing the value generated by the i-th
+         * engine to `output[i]`.
+         *
+         * Behaviour is undefined if the size of `output` is not `size()`.
+         */
+        void generate(ext::array_view<result_type> output) noexcept
+        {
+            assert(output.size() == size());
+
+            auto const a = state_a_.data();
+            auto const b = state_b_.data();
+            auto const c = state_c_.data();
+            auto const counter = counter_.data();
+            auto const out = output.data();
+            auto const n = size();
+
+            for (size_type i = 0; i < n; ++i)
+                out[i] = advance(a[i], b[i], c[i], counter[i]);
+        }
+
+        /**
+         * Advances the engines whose mask is true, storing the value
+         * generated by the i-th engine to `output[i]`. The other engines and
+         * output elements are left unchanged.
+         *
+         * The next states are computed for all engines and selected by the
+         * mask, so the cost does not depend on how many engines are masked.
+         *
+         * Behaviour is undefined if the sizes of `mask` and `output` are not
+         * `size()`.
+         */
+        void generate_masked(ext::array_view<bool const> mask,
+                             ext::array_view<result_type> output) noexcept
+        {
+            assert(mask.size() == size());
+            assert(output.size() == size());
+
+            auto const a = state_a_.data();
+            auto const b = state_b_.data();
+            auto const c = state_c_.data();
+            auto const counter = counter_.data();
+            auto const out = output.data();
+            auto const n = size();
+
+            for (size_type i = 0; i < n; ++i)
+            {
+                auto next_a = a[i];
+                auto next_b = b[i];
+                auto next_c = c[i];
+                auto next_counter = counter[i];
+                auto const value = advance(next_a, next_b, next_c, next_counter);
+
+                auto const on = mask[i];
+                a[i] = on ? next_a : a[i];
+                b[i] = on ? next_b : b[i];
+                c[i] = on ? next_c : c[i];
+                counter[i] = on ? next_counter : counter[i];
+                out[i] = on ? value : out[i];
+            }
+        }
+
+        /**
+         * Advances the engines at given indices in order, storing the value
+         * generated by the engine at `indices[k]` to `output[k]`.
+         *
+         * An index may appear more than once, in which case the engine is
+         * advanced once for each occurrence.
+         *
+         * Behaviour is undefined if the sizes of `indices` and `output`
+         * differ or an index is not less than `size()`.
+         */
+        void generate_indexed(ext::array_view<size_type const> indices,
+                              ext::array_view<result_type> output) noexcept
+        {
+            assert(indices.size() == output.size());
+
+            for (size_type k = 0; k < indices.size(); ++k)
+                output[k] = step(indices[k]);
+        }
+
+        /**
+         * Advances every engine z times.
+         */
+        void discard(unsigned long long z) noexcept
+        {
+            auto const a = state_a_.data();
+            auto const b = state_b_.data();
+            auto const c = state_c_.data();
+            auto const counter = counter_.data();
+            auto const n = size();
+
+            for (; z != 0; --z)
+            {
+                for (size_type i = 0; i < n; ++i)
+                    advance(a[i], b[i], c[i], counter[i]);
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // Comparison operators
+        //----------------------------------------------------------------------
+
+        /*
+         * Compares the internal states of all engines for equality.
+         */
+        friend
+        bool operator==(engine_array const& x, engine_array const& y) noexcept
+        {
+            return x.state_a_ == y.state_a_ &&
+                   x.state_b_ == y.state_b_ &&
+                   x.state_c_ == y.state_c_ &&
+                   x.counter_ == y.counter_;
+        }
+
+        friend
+        bool operator!=(engine_array const& x, engine_array const& y) noexcept
+        {
+            return !(x == y);
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        /*
+         * Same transition as engine_type::operator().
+         */
+        static
+        result_type advance(result_type& a,
+                            result_type& b,
+                            result_type& c,
+                            result_type& counter) noexcept
+        {
+            auto const tmp = result_type(a + b + counter);
+            counter = result_type(counter + 1);
+            a = result_type(b ^ (b >> RightShift));
+            b = result_type(c + (c << LeftShift));
+            c = result_type(ext::rotate(c, BarrelShift) + tmp);
+            return tmp;
+        }
+
+        result_type step(size_type i) noexcept
+        {
+            assert(i < size());
+            return advance(state_a_[i], state_b_[i], state_c_[i], counter_[i]);
+        }
+
+        std::vector<result_type> state_a_;
+        std::vector<result_type> state_b_;
+        std::vector<result_type> state_c_;
+        std::vector<result_type> counter_;
+    };
+}
+
+#endif
@@ -0,0 +1,329 @@
+/*
+ * Polymorphic memory resources.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_MEMORY_RESOURCE_HPP
+#define EXT_MEMORY_RESOURCE_HPP
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace ext
+{
+    //--------------------------------------------------------------------------
+    // Memory resource interface
+    //--------------------------------------------------------------------------
+
+    /**
+     * Interface of memory resources, modeled after C++17
+     * `std::pmr::memory_resource`.
+     */
+    struct memory_resource
+    {
+        virtual
+        ~memory_resource() = default;
+
+        /**
+         * Allocates storage of at least `bytes` bytes aligned to `alignment`.
+         */
+        void* allocate(std::size_t bytes,
+                       std::size_t alignment = alignof(std::max_align_t))
+        {
+            return do_allocate(bytes, alignment);
+        }
+
+        /**
+         * Deallocates storage previously allocated by this resource with the
+         * same size and alignment.
+         */
+        void deallocate(void* ptr,
+                        std::size_t bytes,
+                        std::size_t alignment = alignof(std::max_align_t))
+        {
+            do_deallocate(ptr, bytes, alignment);
+        }
+
+        /**
+         * Checks if storage allocated by this resource can be deallocated by
+         * the other, and vice versa.
+         */
+        bool is_equal(memory_resource const& other) const noexcept
+        {
+            return do_is_equal(other);
+        }
+
+      private:
+        virtual
+        void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+
+        virtual
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) = 0;
+
+        virtual
+        bool do_is_equal(memory_resource const& other) const noexcept = 0;
+    };
+
+    inline
+    bool operator==(memory_resource const& a, memory_resource const& b) noexcept
+    {
+        return &a == &b || a.is_equal(b);
+    }
+
+    inline
+    bool operator!=(memory_resource const& a, memory_resource const& b) noexcept
+    {
+        return !(a == b);
+    }
+
+    //--------------------------------------------------------------------------
+    // Global resource
+    //--------------------------------------------------------------------------
+
+    namespace detail
+    {
+        struct new_delete_resource_impl : ext::memory_resource
+        {
+          private:
+            /*
+             * Over-aligned storage is carved from a larger allocation, with
+             * the address of the allocation stored just before the storage.
+             */
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override
+            {
+                assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+                if (alignment <= alignof(std::max_align_t))
+                    return ::operator new(bytes);
+
+                void* const base = ::operator new(bytes + alignment);
+                auto const address = reinterpret_cast<std::uintptr_t>(base);
+                auto const aligned = (address / alignment + 1) * alignment;
+                auto const ptr = reinterpret_cast<void**>(aligned);
+                ptr[-1] = base;
+                return ptr;
+            }
+
+            void do_deallocate(void* ptr, std::size_t, std::size_t alignment) override
+            {
+                if (alignment <= alignof(std::max_align_t))
+                    ::operator delete(ptr);
+                else
+                    ::operator delete(static_cast<void**>(ptr)[-1]);
+            }
+
+            bool do_is_equal(memory_resource const& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+    }
+
+    /**
+     * Returns the resource that uses global `operator new` and `operator
+     * delete`.
+     *
+     * Over-aligned requests allocate `alignment` extra bytes and align the
+     * storage within them.
+     */
+    inline
+    ext::memory_resource* new_delete_resource() noexcept
+    {
+        static detail::new_delete_resource_impl resource;
+        return &resource;
+    }
+
+    //--------------------------------------------------------------------------
+    // Monotonic buffer resource
+    //--------------------------------------------------------------------------
+
+    /**
+     * Memory resource that hands out storage from a growing arena and frees
+     * it all at once.
+     *
+     * `deallocate` does nothing. Storage is returned to the upstream
+     * resource by `release()` or the destructor. Use this for objects with
+     * the same lifetime, such as those scoped to a request.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::monotonic_buffer_resource arena;
+     * std::vector<ext::any> attributes;
+     * attributes.emplace_back(std::allocator_arg, &arena, make_payload());
+     * ```
+     */
+    struct monotonic_buffer_resource : ext::memory_resource
+    {
+        /**
+         * Constructs a resource whose first chunk has given size.
+         */
+        explicit
+        monotonic_buffer_resource(
+            std::size_t initial_size = 1024,
+            ext::memory_resource* upstream = ext::new_delete_resource())
+            : upstream_ {upstream}
+            , next_size_ {std::max(initial_size, std::size_t(1))}
+        {
+            assert(upstream);
+        }
+
+        /**
+         * Constructs a resource that first uses given buffer. The buffer is
+         * not owned by the resource.
+         */
+        monotonic_buffer_resource(
+            void* buffer,
+            std::size_t size,
+            ext::memory_resource* upstream = ext::new_delete_resource())
+            : upstream_ {upstream}
+            , current_ {static_cast<char*>(buffer)}
+            , remaining_ {size}
+            , next_size_ {std::max(size, std::size_t(1)) * 2}
+        {
+            assert(upstream);
+        }
+
+        monotonic_buffer_resource(monotonic_buffer_resource const&) = delete;
+
+        monotonic_buffer_resource&
+        operator=(monotonic_buffer_resource const&) = delete;
+
+        /**
+         * Returns all storage to the upstream resource.
+         */
+        ~monotonic_buffer_resource()
+        {
+            release();
+        }
+
+        /**
+         * Returns all storage obtained from the upstream resource. Storage
+         * handed out so far becomes invalid.
+         */
+        void release() noexcept
+        {
+            while (chunks_)
+            {
+                auto const chunk = chunks_;
+                chunks_ = chunk->next;
+                upstream_->deallocate(chunk, chunk->size, alignof(chunk_header));
+            }
+            current_ = nullptr;
+            remaining_ = 0;
+        }
+
+        /**
+         * Returns the upstream resource.
+         */
+        ext::memory_resource* upstream_resource() const noexcept
+        {
+            return upstream_;
+        }
+
+      private:
+        struct chunk_header
+        {
+            chunk_header* next;
+            std::size_t size;
+        };
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            if (void* ptr = carve(bytes, alignment))
+                return ptr;
+
+            auto const required = sizeof(chunk_header) + bytes + alignment;
+            auto const size = std::max(next_size_, required);
+
+            void* const storage = upstream_->allocate(size, alignof(chunk_header));
+            auto const chunk = ::new(storage) chunk_header {chunks_, size};
+            chunks_ = chunk;
+            current_ = reinterpret_cast<char*>(chunk + 1);
+            remaining_ = size - sizeof(chunk_header);
+            next_size_ = size * 2;
+
+            void* const ptr = carve(bytes, alignment);
+            assert(ptr);
+            return ptr;
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override
+        {
+        }
+
+        bool do_is_equal(memory_resource const& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        /*
+         * Takes aligned storage from the current chunk, or returns null if
+         * the chunk does not have enough space.
+         */
+        void* carve(std::size_t bytes, std::size_t alignment) noexcept
+        {
+            if (!current_)
+                return nullptr;
+
+            auto const address = reinterpret_cast<std::uintptr_t>(current_);
+            auto const padding = (alignment - address % alignment) % alignment;
+            if (padding + bytes > remaining_)
+                return nullptr;
+
+            void* const ptr = current_ + padding;
+            current_ += padding + bytes;
+            remaining_ -= padding + bytes;
+            return ptr;
+        }
+
+        ext::memory_resource* upstream_;
+        chunk_header* chunks_ = nullptr;
+        char* current_ = nullptr;
+        std::size_t remaining_ = 0;
+        std::size_t next_size_;
+    };
+
+    //--------------------------------------------------------------------------
+    // Object construction
+    //--------------------------------------------------------------------------
+
+    /**
+     * Allocates storage for an object of type T from the resource and
+     * constructs the object in it. The storage is deallocated if the
+     * constructor throws.
+     */
+    template<typename T, typename... Args>
+    T* new_object(ext::memory_resource* resource, Args&&... args)
+    {
+        void* const ptr = resource->allocate(sizeof(T), alignof(T));
+        try
+        {
+            return ::new(ptr) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            resource->deallocate(ptr, sizeof(T), alignof(T));
+            throw;
+        }
+    }
+
+    /**
+     * Destroys an object created by `ext::new_object` with the same resource
+     * and deallocates its storage.
+     */
+    template<typename T>
+    void delete_object(ext::memory_resource* resource, T* ptr) noexcept
+    {
+        ptr->~T();
+        resource->deallocate(ptr, sizeof(T), alignof(T));
+    }
+}
+
+#endif
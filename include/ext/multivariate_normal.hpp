@@ -0,0 +1,254 @@
+/*
+ * Multivariate normal distribution with cached Cholesky factor.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_MULTIVARIATE_NORMAL_HPP
+#define EXT_MULTIVARIATE_NORMAL_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "array_view.hpp"
+#include "ziggurat_normal_distribution.hpp"
+
+namespace ext
+{
+    namespace detail
+    {
+        /*
+         * Computes the dot product of two arrays of length n. Four partial
+         * sums are used to break the dependency chain of additions.
+         */
+        template<typename T>
+        T dot_product(T const* x, T const* y, std::size_t n)
+        {
+            T sum_0 = 0;
+            T sum_1 = 0;
+            T sum_2 = 0;
+            T sum_3 = 0;
+            std::size_t i = 0;
+
+            for (; i + 4 <= n; i += 4)
+            {
+                sum_0 += x[i + 0] * y[i + 0];
+                sum_1 += x[i + 1] * y[i + 1];
+                sum_2 += x[i + 2] * y[i + 2];
+                sum_3 += x[i + 3] * y[i + 3];
+            }
+            for (; i < n; ++i)
+                sum_0 += x[i] * y[i];
+
+            return (sum_0 + sum_1) + (sum_2 + sum_3);
+        }
+    }
+
+    /**
+     * Produces real vectors on the multivariate normal distribution.
+     *
+     * The covariance matrix is factored as `L L^T` once on construction and
+     * the lower triangular factor `L` is stored row by row in packed form.
+     * A sample is then computed as `mean + L z` where `z` is a vector of
+     * independent standard normal values drawn by the ziggurat algorithm.
+     *
+     * === Example ===
+     *
+     * ```
+     * double const mean[] = {0, 0};
+     * double const cov[] = {1.0, 0.5,
+     *                       0.5, 2.0};
+     * ext::multivariate_normal<double> normal {mean, cov};
+     *
+     * std::vector<double> samples(1000 * normal.dimension());
+     * normal.fill(engine, samples);
+     * ```
+     */
+    template<typename T = double>
+    struct multivariate_normal
+    {
+        using result_type = T;
+        using size_type = std::size_t;
+
+        //----------------------------------------------------------------------
+        // Construction
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs the distribution with specified mean vector and
+         * covariance matrix.
+         *
+         * @param mean
+         *      Mean vector of length d.
+         *
+         * @param covariance
+         *      Symmetric positive definite d-by-d matrix in row-major order.
+         *      Only the lower triangle is read.
+         *
+         * Behaviour is undefined if the sizes do not match or the covariance
+         * matrix is not positive definite.
+         */
+        multivariate_normal(ext::array_view<T const> mean,
+                            ext::array_view<T const> covariance)
+            : dimension_ {mean.size()}
+            , mean_(mean.begin(), mean.end())
+            , factor_(mean.size() * (mean.size() + 1) / 2)
+        {
+            assert(covariance.size() == dimension_ * dimension_);
+            factorize(covariance);
+        }
+
+        //----------------------------------------------------------------------
+        // Characteristics
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the number of components of a sample.
+         */
+        size_type dimension() const noexcept
+        {
+            return dimension_;
+        }
+
+        /**
+         * Returns the mean vector.
+         */
+        ext::array_view<T const> mean() const noexcept
+        {
+            return {mean_.data(), mean_.size()};
+        }
+
+        /**
+         * Returns the lower triangular Cholesky factor of the covariance
+         * matrix in packed row-major form, i.e. row `i` has `i + 1` elements
+         * starting at the offset `i * (i + 1) / 2`.
+         */
+        ext::array_view<T const> cholesky_factor() const noexcept
+        {
+            return {factor_.data(), factor_.size()};
+        }
+
+        /**
+         * Does nothing. The distribution has no internal state.
+         */
+        void reset() noexcept
+        {
+        }
+
+        //----------------------------------------------------------------------
+        // Generation
+        //----------------------------------------------------------------------
+
+        /**
+         * Generates a single random vector.
+         *
+         * Behaviour is undefined if the size of `sample` is not equal to
+         * `dimension()`.
+         */
+        template<typename URNG>
+        void operator()(URNG& engine, ext::array_view<T> sample)
+        {
+            assert(sample.size() == dimension_);
+            fill(engine, sample);
+        }
+
+        /**
+         * Fills the view with random vectors.
+         *
+         * The view is treated as a k-by-d matrix in row-major order and each
+         * row receives a sample. Standard normal values for all the samples
+         * are generated first, and then transformed in place in blocks of
+         * rows so that the working set stays in cache.
+         *
+         * Behaviour is undefined if the size of `samples` is not a multiple
+         * of `dimension()`.
+         */
+        template<typename URNG>
+        void fill(URNG& engine, ext::array_view<T> samples)
+        {
+            assert(dimension_ == 0 || samples.size() % dimension_ == 0);
+
+            if (dimension_ == 0)
+                return;
+
+            normal_.fill(engine, samples);
+
+            size_type const count = samples.size() / dimension_;
+            size_type const block = std::max<size_type>(
+                1, block_bytes / (dimension_ * sizeof(T)));
+
+            for (size_type start = 0; start < count; start += block)
+            {
+                size_type const end = std::min(start + block, count);
+                transform(samples.data() + start * dimension_, end - start);
+            }
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        // Target size of a block of samples processed at once. This fits in
+        // L2 cache on common processors.
+        static constexpr size_type block_bytes = 128 * 1024;
+
+        /*
+         * Computes the Cholesky factor with the Cholesky-Banachiewicz
+         * algorithm, which proceeds row by row and thus matches the packed
+         * row-major storage.
+         */
+        void factorize(ext::array_view<T const> covariance)
+        {
+            for (size_type i = 0; i < dimension_; ++i)
+            {
+                T* const row_i = factor_.data() + i * (i + 1) / 2;
+
+                for (size_type j = 0; j <= i; ++j)
+                {
+                    T const* const row_j = factor_.data() + j * (j + 1) / 2;
+                    T const sum = covariance[i * dimension_ + j]
+                                  - detail::dot_product(row_i, row_j, j);
+                    if (i == j)
+                    {
+                        assert(sum > 0);
+                        row_i[j] = std::sqrt(sum);
+                    }
+                    else
+                    {
+                        row_i[j] = sum / row_j[j];
+                    }
+                }
+            }
+        }
+
+        /*
+         * Transforms count rows of standard normal values into samples in
+         * place. Component i of a sample depends only on the components up to
+         * i, so the components are overwritten from the last one. Each row of
+         * the factor is then reused across all the rows in the block.
+         */
+        void transform(T* block, size_type count) const
+        {
+            for (size_type i = dimension_; i-- > 0; )
+            {
+                T const* const row = factor_.data() + i * (i + 1) / 2;
+                T const mean = mean_[i];
+
+                for (size_type s = 0; s < count; ++s)
+                {
+                    T* const z = block + s * dimension_;
+                    z[i] = mean + detail::dot_product(row, z, i + 1);
+                }
+            }
+        }
+
+        size_type dimension_;
+        std::vector<T> mean_;
+        std::vector<T> factor_;
+        ext::ziggurat_normal_distribution<T> normal_;
+    };
+}
+
+#endif
@@ -0,0 +1,253 @@
+/*
+ * Deterministic parallel random number generation.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_PARALLEL_RANDOM_HPP
+#define EXT_PARALLEL_RANDOM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "array_view.hpp"
+#include "seed_seq_fe.hpp"
+#include "small_fast_counting_engine_v4.hpp"
+
+namespace ext
+{
+    /**
+     * Options for `ext::parallel_generate` and `ext::parallel_for_random`.
+     */
+    struct parallel_random_options
+    {
+        /**
+         * Number of indices processed with a single random stream. Results
+         * depend on this value, so keep it fixed for reproducibility.
+         */
+        std::size_t chunk_size = 4096;
+
+        /**
+         * Number of threads to use. Zero means the number of hardware
+         * threads. Results do not depend on this value.
+         */
+        unsigned thread_count = 0;
+    };
+
+    /**
+     * Creates the random number engine for a chunk.
+     *
+     * The engine is seeded with the job seed and the chunk index through
+     * `ext::seed_seq_fe`, so each chunk has its own stream regardless of
+     * which thread processes it. A domain word keeps the streams apart from
+     * those of `ext::thread_engine` for equal seed and index.
+     */
+    inline
+    ext::sfc64 make_chunk_engine(std::uint64_t seed, std::uint64_t chunk)
+    {
+        constexpr std::uint32_t domain = 0x63686e6b; // "chnk"
+
+        ext::seed_seq_fe<4> seed_seq {
+            std::uint32_t(seed),
+            std::uint32_t(seed >> 32),
+            std::uint32_t(chunk),
+            std::uint32_t(chunk >> 32),
+            domain
+        };
+        return ext::sfc64 {seed_seq};
+    }
+
+    namespace detail
+    {
+        /*
+         * Joins the threads on destruction, including during unwinding.
+         */
+        struct thread_joiner
+        {
+            std::vector<std::thread>& threads;
+
+            ~thread_joiner()
+            {
+                for (auto& thread : threads)
+                    thread.join();
+            }
+        };
+
+        /*
+         * Calls task(chunk) for each chunk in [0, chunk_count) on a number of
+         * threads. Chunks are handed out dynamically. The first exception
+         * thrown by a task is rethrown after all threads have finished.
+         */
+        template<typename Task>
+        void run_chunks(std::size_t chunk_count, unsigned thread_count, Task& task)
+        {
+            if (thread_count == 0)
+                thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+            auto const worker_count = static_cast<unsigned>(
+                std::min<std::size_t>(thread_count, chunk_count));
+
+            std::atomic<std::size_t> next {0};
+            std::atomic<bool> failed {false};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            auto const work = [&] {
+                for (;;)
+                {
+                    auto const chunk = next.fetch_add(1);
+                    if (chunk >= chunk_count || failed.load())
+                        break;
+
+                    try
+                    {
+                        task(chunk);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock {error_mutex};
+                        if (!error)
+                            error = std::current_exception();
+                        failed.store(true);
+                    }
+                }
+            };
+
+            {
+                std::vector<std::thread> threads;
+                detail::thread_joiner const joiner {threads};
+                try
+                {
+                    for (unsigned i = 1; i < worker_count; ++i)
+                        threads.emplace_back(work);
+                }
+                catch (...)
+                {
+                    // Stop the started workers before they are joined.
+                    failed.store(true);
+                    throw;
+                }
+                work();
+            }
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * Fills the view in parallel with values computed from random streams.
+     *
+     * The view is split into chunks of `options.chunk_size` elements, and
+     * `fn(engine, chunk, offset)` is called for each chunk, where `engine`
+     * is `ext::make_chunk_engine(seed, chunk_index)` and `offset` is the
+     * index of the first element of the chunk. The output is therefore
+     * identical for any number of threads.
+     *
+     * === Example ===
+     *
+     * ```
+     * std::vector<double> values(1000000);
+     * ext::parallel_generate(
+     *     ext::array_view<double>(values), seed,
+     *     [](ext::sfc64& engine, ext::array_view<double> chunk, std::size_t) {
+     *         ext::ziggurat_normal_distribution<double> normal;
+     *         normal.fill(engine, chunk);
+     *     });
+     * ```
+     */
+    template<typename T, typename Fn>
+    void parallel_generate(ext::array_view<T> output,
+                           std::uint64_t seed,
+                           Fn fn,
+                           ext::parallel_random_options options = {})
+    {
+        assert(options.chunk_size > 0);
+
+        auto const chunk_size = options.chunk_size;
+        auto const chunk_count = (output.size() + chunk_size - 1) / chunk_size;
+
+        auto task = [&](std::size_t chunk) {
+            auto const start = chunk * chunk_size;
+            auto const end = std::min(start + chunk_size, output.size());
+            auto engine = ext::make_chunk_engine(seed, chunk);
+            fn(engine, output.slice(start, end), start);
+        };
+        detail::run_chunks(chunk_count, options.thread_count, task);
+    }
+
+    /**
+     * Computes a reduction in parallel over values computed from random
+     * streams.
+     *
+     * The index space [0, count) is split into chunks of
+     * `options.chunk_size` indices, and `fn(engine, begin, end)` is called
+     * for each chunk to compute a partial result, where `engine` is
+     * `ext::make_chunk_engine(seed, chunk_index)`. Partial results are
+     * combined with `reduce` in a fixed pairwise tree over chunk indices, and
+     * finally with `init` as `reduce(init, tree)`. The result is therefore
+     * bit-identical for any number of threads, even for floating-point sums.
+     *
+     * === Example ===
+     *
+     * ```
+     * auto const hits = ext::parallel_for_random(
+     *     1000000, seed, 0L,
+     *     [](ext::sfc64& engine, std::size_t begin, std::size_t end) {
+     *         std::uniform_real_distribution<double> uniform;
+     *         long count = 0;
+     *         for (auto i = begin; i < end; ++i) {
+     *             auto const x = uniform(engine);
+     *             auto const y = uniform(engine);
+     *             count += (x * x + y * y < 1);
+     *         }
+     *         return count;
+     *     },
+     *     std::plus<long>());
+     * ```
+     */
+    template<typename T, typename Fn, typename Reduce>
+    T parallel_for_random(std::size_t count,
+                          std::uint64_t seed,
+                          T init,
+                          Fn fn,
+                          Reduce reduce,
+                          ext::parallel_random_options options = {})
+    {
+        assert(options.chunk_size > 0);
+
+        auto const chunk_size = options.chunk_size;
+        auto const chunk_count = (count + chunk_size - 1) / chunk_size;
+
+        if (chunk_count == 0)
+            return init;
+
+        std::vector<T> results(chunk_count, init);
+
+        auto task = [&](std::size_t chunk) {
+            auto const begin = chunk * chunk_size;
+            auto const end = std::min(begin + chunk_size, count);
+            auto engine = ext::make_chunk_engine(seed, chunk);
+            results[chunk] = fn(engine, begin, end);
+        };
+        detail::run_chunks(chunk_count, options.thread_count, task);
+
+        for (std::size_t stride = 1; stride < chunk_count; stride *= 2)
+        {
+            for (std::size_t i = 0; i + stride < chunk_count; i += 2 * stride)
+                results[i] = reduce(results[i], results[i + stride]);
+        }
+
+        return reduce(init, results[0]);
+    }
+}
+
+#endif
@@ -0,0 +1,260 @@
+/*
+ * Poisson distribution implemented with transformed rejection.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_POISSON_DISTRIBUTION_HPP
+#define EXT_POISSON_DISTRIBUTION_HPP
+
+#include <array>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "array_view.hpp"
+
+namespace ext
+{
+    /**
+     * Produces non-negative integers on the Poisson distribution.
+     *
+     * Means smaller than 10 are sampled by inversion of a cumulative
+     * probability table computed on construction. The search beyond the table
+     * stops at `mean + 20 sqrt(mean)`; a deviate that falls past the rounded
+     * sum of the probabilities is redrawn. Larger means are sampled
+     * with the PTRS transformed rejection algorithm [1], which takes about
+     * two uniform deviates per sample regardless of the mean.
+     *
+     * [1]: W. Hörmann, "The transformed rejection method for generating
+     *      Poisson random variables", Insurance: Mathematics and Economics
+     *      12 (1993) 39-45.
+     */
+    template<typename IntType = int>
+    struct poisson_distribution
+    {
+        static_assert(std::is_integral<IntType>::value, "invalid result type");
+
+        using result_type = IntType;
+
+      private:
+        static constexpr double inversion_limit = 10;
+        static constexpr std::size_t table_size = 48;
+
+      public:
+        //----------------------------------------------------------------------
+        // Construction
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs the distribution with specified mean.
+         *
+         * Behaviour is undefined if the mean is negative.
+         */
+        explicit
+        poisson_distribution(double mean = 1.0)
+            : mean_ {mean}
+        {
+            assert(mean >= 0);
+
+            if (mean < inversion_limit)
+                setup_inversion();
+            else
+                setup_ptrs();
+        }
+
+        //----------------------------------------------------------------------
+        // Characteristics
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the mean of the distribution.
+         */
+        double mean() const noexcept
+        {
+            return mean_;
+        }
+
+        result_type min() const noexcept
+        {
+            return 0;
+        }
+
+        result_type max() const noexcept
+        {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        /**
+         * Does nothing. The distribution has no internal state.
+         */
+        void reset() noexcept
+        {
+        }
+
+        //----------------------------------------------------------------------
+        // Generation
+        //----------------------------------------------------------------------
+
+        /**
+         * Generates a random number.
+         */
+        template<typename URNG>
+        result_type operator()(URNG& engine) const
+        {
+            if (mean_ < inversion_limit)
+                return sample_by_inversion(engine);
+            else
+                return sample_by_ptrs(engine);
+        }
+
+        /**
+         * Fills the view with random numbers.
+         *
+         * The choice of algorithm is hoisted out of the loop, so this is
+         * faster than calling `operator()` for each element.
+         */
+        template<typename URNG>
+        void fill(URNG& engine, ext::array_view<result_type> output) const
+        {
+            if (mean_ < inversion_limit)
+            {
+                for (auto& value : output)
+                    value = sample_by_inversion(engine);
+            }
+            else
+            {
+                for (auto& value : output)
+                    value = sample_by_ptrs(engine);
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // Comparison operators
+        //----------------------------------------------------------------------
+
+        friend
+        bool operator==(poisson_distribution const& x,
+                        poisson_distribution const& y) noexcept
+        {
+            return x.mean_ == y.mean_;
+        }
+
+        friend
+        bool operator!=(poisson_distribution const& x,
+                        poisson_distribution const& y) noexcept
+        {
+            return !(x == y);
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        template<typename URNG>
+        static double canonical(URNG& engine)
+        {
+            return std::generate_canonical<
+                double, std::numeric_limits<double>::digits>(engine);
+        }
+
+        void setup_inversion()
+        {
+            double prob = std::exp(-mean_);
+            double cum = prob;
+
+            cdf_[0] = cum;
+            for (std::size_t k = 1; k < table_size; ++k)
+            {
+                prob *= mean_ / double(k);
+                cum += prob;
+                cdf_[k] = cum;
+            }
+            last_prob_ = prob;
+            tail_limit_ = std::fmax(double(table_size - 1),
+                                    std::ceil(mean_ + 20 * std::sqrt(mean_)));
+        }
+
+        void setup_ptrs()
+        {
+            double const smu = std::sqrt(mean_);
+            b_ = 0.931 + 2.53 * smu;
+            a_ = -0.059 + 0.02483 * b_;
+            vr_ = 0.9277 - 3.6224 / (b_ - 2);
+            log_inv_alpha_ = std::log(1.1239 + 1.1328 / (b_ - 3.4));
+            log_mean_ = std::log(mean_);
+        }
+
+        template<typename URNG>
+        result_type sample_by_inversion(URNG& engine) const
+        {
+            for (;;)
+            {
+                double const u = canonical(engine);
+
+                for (std::size_t k = 0; k < table_size; ++k)
+                {
+                    if (u < cdf_[k])
+                        return result_type(k);
+                }
+
+                // Extremely rare: continue the recurrence beyond the table.
+                double k = table_size - 1;
+                double prob = last_prob_;
+                double cum = cdf_[table_size - 1];
+                while (u >= cum && k < tail_limit_)
+                {
+                    k += 1;
+                    prob *= mean_ / k;
+                    cum += prob;
+                }
+                if (u < cum)
+                    return result_type(k);
+
+                // u is beyond the rounded total probability.
+            }
+        }
+
+        template<typename URNG>
+        result_type sample_by_ptrs(URNG& engine) const
+        {
+            for (;;)
+            {
+                double const u = canonical(engine) - 0.5;
+                double const v = canonical(engine);
+                double const us = 0.5 - std::fabs(u);
+                double const k = std::floor((2 * a_ / us + b_) * u + mean_ + 0.43);
+
+                if (us >= 0.07 && v <= vr_) // taken 86% to 89% of times
+                    return result_type(k);
+
+                if (k < 0 || (us < 0.013 && v > us))
+                    continue;
+
+                double const lhs = std::log(v) + log_inv_alpha_
+                                    - std::log(a_ / (us * us) + b_);
+                double const rhs = -mean_ + k * log_mean_ - std::lgamma(k + 1);
+                if (lhs <= rhs)
+                    return result_type(k);
+            }
+        }
+
+        double mean_;
+
+        // Inversion
+        std::array<double, table_size> cdf_ {{}};
+        double last_prob_ = 0;
+        double tail_limit_ = 0;
+
+        // PTRS
+        double a_ = 0;
+        double b_ = 0;
+        double vr_ = 0;
+        double log_inv_alpha_ = 0;
+        double log_mean_ = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * Polymorphic collection with per-type segments.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_POLY_COLLECTION_HPP
+#define EXT_POLY_COLLECTION_HPP
+
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+#include <cstddef>
+
+#include "array_view.hpp"
+#include "clone_ptr.hpp"
+#include "type_map.hpp"
+
+namespace ext
+{
+    namespace detail
+    {
+        /*
+         * Segment of objects of one dynamic type. The layout of the elements
+         * is mirrored in the base so that they can be walked as T without a
+         * virtual call per element.
+         */
+        template<typename T>
+        struct poly_segment_base
+        {
+            explicit
+            poly_segment_base(ext::type_id id) noexcept
+                : type {id}
+            {
+            }
+
+            virtual
+            ~poly_segment_base() = default;
+
+            virtual
+            std::unique_ptr<poly_segment_base> clone() const = 0;
+
+            virtual
+            void clear() noexcept = 0;
+
+            T* base(std::size_t i) const noexcept
+            {
+                return reinterpret_cast<T*>(data + i * stride + base_offset);
+            }
+
+            ext::type_id type;
+            unsigned char* data = nullptr;
+            std::size_t size = 0;
+            std::size_t stride = 0;
+            std::ptrdiff_t base_offset = 0;
+        };
+
+        template<typename S, typename T>
+        struct poly_segment : poly_segment_base<T>
+        {
+            poly_segment()
+                : poly_segment_base<T> {ext::type_id_of<S>()}
+            {
+                this->stride = sizeof(S);
+            }
+
+            poly_segment(poly_segment const& other)
+                : poly_segment_base<T> {other}
+                , values {other.values}
+            {
+                sync();
+            }
+
+            std::unique_ptr<poly_segment_base<T>> clone() const override
+            {
+                return std::make_unique<poly_segment>(*this);
+            }
+
+            void clear() noexcept override
+            {
+                values.clear();
+                sync();
+            }
+
+            template<typename... Args>
+            S& emplace(Args&&... args)
+            {
+                values.emplace_back(std::forward<Args>(args)...);
+                sync();
+                return values.back();
+            }
+
+            void sync() noexcept
+            {
+                this->data = reinterpret_cast<unsigned char*>(values.data());
+                this->size = values.size();
+                if (!values.empty())
+                {
+                    auto const object = &values.front();
+                    this->base_offset =
+                        reinterpret_cast<unsigned char*>(static_cast<T*>(object)) -
+                        reinterpret_cast<unsigned char*>(object);
+                }
+            }
+
+            std::vector<S> values;
+        };
+    }
+
+    /**
+     * Collection of polymorphic objects derived from T, stored in one
+     * contiguous segment per dynamic type.
+     *
+     * Objects of the same type are adjacent in memory, and `for_each` walks
+     * the collection segment by segment. Passing derived types as template
+     * arguments to `for_each` makes it call the function with the static
+     * type of the segment, so calls on `final` types are devirtualized and
+     * can be inlined. Other segments are visited as T.
+     *
+     * Elements are grouped by type, so insertion order is only kept among
+     * objects of the same type. Insertion invalidates references to objects
+     * of the same type. Segments are looked up linearly, which suits a
+     * handful of types.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::poly_collection<shape> shapes;
+     * shapes.insert(circle {1.0});
+     * shapes.insert(square {2.0});
+     *
+     * double total = 0;
+     * shapes.for_each<circle, square>([&](auto const& s) {
+     *     total += s.area();
+     * });
+     * ```
+     */
+    template<typename T>
+    struct poly_collection
+    {
+        using size_type = std::size_t;
+
+        //----------------------------------------------------------------------
+        // Capacity
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the number of objects.
+         */
+        size_type size() const noexcept
+        {
+            size_type total = 0;
+            for (auto const& segment : segments_)
+                total += segment->size;
+            return total;
+        }
+
+        /**
+         * Checks if there is no object.
+         */
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        /**
+         * Returns the number of objects of type S.
+         */
+        template<typename S>
+        size_type count() const noexcept
+        {
+            auto const segment = find(ext::type_id_of<S>());
+            return segment ? segment->size : 0;
+        }
+
+        //----------------------------------------------------------------------
+        // Modifiers
+        //----------------------------------------------------------------------
+
+        /**
+         * Inserts a copy of given object into the segment of its type and
+         * returns a reference to the stored object.
+         *
+         * The segment is chosen by the static type of the argument, which
+         * must be the dynamic type of the object; otherwise the object would
+         * be sliced. Passing a reference to the base type is rejected at
+         * compile time unless the base type is final, and other mismatches
+         * are caught by an assertion where RTTI is available. Use `emplace`
+         * to insert an object of the base type itself.
+         */
+        template<typename S>
+        std::decay_t<S>& insert(S&& value)
+        {
+            using type = std::decay_t<S>;
+
+            static_assert(!std::is_same<type, T>::value || std::is_final<T>::value,
+                          "inserting through a base reference slices the object");
+            assert(is_dynamic_type(value));
+
+            return emplace<type>(std::forward<S>(value));
+        }
+
+        /**
+         * Inserts an object of type S constructed from given arguments into
+         * the segment of S and returns a reference to it.
+         */
+        template<typename S, typename... Args>
+        S& emplace(Args&&... args)
+        {
+            static_assert(std::is_base_of<T, S>::value,
+                          "object type must be derived from the base type");
+
+            return segment<S>().emplace(std::forward<Args>(args)...);
+        }
+
+        /**
+         * Destroys all objects. Segments are kept for reuse.
+         */
+        void clear() noexcept
+        {
+            for (auto& segment : segments_)
+                segment->clear();
+        }
+
+        //----------------------------------------------------------------------
+        // Access
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns a view of the objects of type S.
+         */
+        template<typename S>
+        ext::array_view<S> segment_view() noexcept
+        {
+            auto const segment = find(ext::type_id_of<S>());
+            if (!segment)
+                return {};
+            return {reinterpret_cast<S*>(segment->data), segment->size};
+        }
+
+        template<typename S>
+        ext::array_view<S const> segment_view() const noexcept
+        {
+            auto const segment = find(ext::type_id_of<S>());
+            if (!segment)
+                return {};
+            return {reinterpret_cast<S const*>(segment->data), segment->size};
+        }
+
+        /**
+         * Calls `fun(object)` for each object, segment by segment. Objects in
+         * the segments of `Ss...` are passed with their static type; others
+         * are passed as T.
+         */
+        template<typename... Ss, typename F>
+        void for_each(F fun)
+        {
+            for (auto const& segment : segments_)
+                visit_segment<T, Ss...>(*segment, fun);
+        }
+
+        template<typename... Ss, typename F>
+        void for_each(F fun) const
+        {
+            for (auto const& segment : segments_)
+                visit_segment<T const, Ss const...>(*segment, fun);
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        using segment_base = detail::poly_segment_base<T>;
+
+        segment_base* find(ext::type_id type) const noexcept
+        {
+            for (auto const& segment : segments_)
+            {
+                if (segment->type == type)
+                    return segment.get();
+            }
+            return nullptr;
+        }
+
+        /*
+         * Checks if the dynamic type of the object is its static type, where
+         * RTTI is available.
+         */
+        template<typename S>
+        static bool is_dynamic_type(S const& object) noexcept
+        {
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
+            return std::is_final<S>::value || typeid(object) == typeid(S);
+#else
+            static_cast<void>(object);
+            return true;
+#endif
+        }
+
+        template<typename S>
+        detail::poly_segment<S, T>& segment()
+        {
+            using segment_type = detail::poly_segment<S, T>;
+
+            if (auto const segment = find(ext::type_id_of<S>()))
+                return static_cast<segment_type&>(*segment);
+
+            segments_.reserve(segments_.size() + 1);
+            segments_.emplace_back(new segment_type);
+            return static_cast<segment_type&>(*segments_.back());
+        }
+
+        /*
+         * Walks the segment with its static type if it is one of Ss, or as
+         * Base otherwise.
+         */
+        template<typename Base, typename... Ss, typename F>
+        static void visit_segment(segment_base const& segment, F& fun)
+        {
+            bool done = false;
+            static_cast<void>(std::initializer_list<int> {
+                (done = done || visit_typed<Ss>(segment, fun), 0)...
+            });
+
+            if (!done)
+            {
+                for (std::size_t i = 0; i < segment.size; ++i)
+                    fun(static_cast<Base&>(*segment.base(i)));
+            }
+        }
+
+        template<typename S, typename F>
+        static bool visit_typed(segment_base const& segment, F& fun)
+        {
+            if (segment.type != ext::type_id_of<std::remove_const_t<S>>())
+                return false;
+
+            auto const objects = reinterpret_cast<S*>(segment.data);
+            for (std::size_t i = 0; i < segment.size; ++i)
+                fun(objects[i]);
+            return true;
+        }
+
+        std::vector<ext::clone_ptr<segment_base>> segments_;
+    };
+}
+
+#endif
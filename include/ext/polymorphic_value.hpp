@@ -7,64 +7,698 @@
 #ifndef EXT_POLYMORPHIC_VALUE_HPP
 #define EXT_POLYMORPHIC_VALUE_HPP
 
+#include <algorithm>
+#include <initializer_list>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "memory_resource.hpp"
+#include "type_map.hpp"
+
 namespace ext
 {
     //--------------------------------------------------------------------------
-    // Type erasure
+    // Storage policies
     //--------------------------------------------------------------------------
 
-    template<typename T>
-    struct polymorphic_placeholder
+    /**
+     * Storage policy of `ext::polymorphic_value` that stores objects of up to
+     * `Size` bytes and alignment `Align` in place.
+     *
+     * Objects that are larger, more aligned, or not nothrow move constructible
+     * are allocated from a memory resource. `inline_storage<0>` allocates
+     * every object, and makes a polymorphic_value the size of a pointer.
+     */
+    template<std::size_t Size, std::size_t Align = alignof(void*)>
+    struct inline_storage
     {
-        virtual
-        ~polymorphic_placeholder() = default;
-
-        virtual
-        std::unique_ptr<polymorphic_placeholder> clone() const = 0;
-
-        virtual
-        T& value() noexcept = 0;
     };
 
-    template<typename S, typename T>
-    struct polymorphic_holder : ext::polymorphic_placeholder<T>
+    /**
+     * Storage policy of `ext::polymorphic_value` that restricts the dynamic
+     * type to one of `Ds...` and stores the object in place.
+     */
+    template<typename... Ds>
+    struct closed_set
     {
-        static_assert(std::is_copy_constructible<S>::value,
-                      "contained type must be copy constructible");
+    };
 
-        polymorphic_holder(S const& value)
-            : value_(value)
+    //--------------------------------------------------------------------------
+    // Type erasure
+    //--------------------------------------------------------------------------
+
+    namespace detail
+    {
+        /*
+         * Storage of the contained object. Small objects live in the buffer;
+         * others are allocated and pointed to by `heap`.
+         */
+        template<std::size_t Size, std::size_t Align>
+        union polymorphic_buffer
         {
-        }
+            void* heap;
+            std::aligned_storage_t<
+                (Size > sizeof(void*) ? Size : sizeof(void*)), Align> buffer;
+        };
 
-        polymorphic_holder(S&& value)
-            : value_(std::move(value))
+        /*
+         * True if objects of type S are stored in the buffer.
+         */
+        template<typename S, std::size_t Size, std::size_t Align>
+        struct polymorphic_is_local : std::integral_constant<bool,
+            Size != 0 &&
+            sizeof(S) <= Size &&
+            alignof(polymorphic_buffer<Size, Align>) % alignof(S) == 0 &&
+            std::is_nothrow_move_constructible<S>::value>
         {
-        }
+        };
 
+        /*
+         * True if any of args lies in the size bytes at storage, so that
+         * destroying the object there would invalidate it.
+         */
         template<typename... Args>
-        polymorphic_holder(Args&&... args)
-            : value_(std::forward<Args>(args)...)
+        bool polymorphic_aliases(void const* storage,
+                                 std::size_t size,
+                                 Args const&... args) noexcept
         {
+            auto const begin = reinterpret_cast<std::uintptr_t>(storage);
+            bool const aliases[] = {false,
+                (reinterpret_cast<std::uintptr_t>(std::addressof(args)) - begin < size)...};
+            return std::find(aliases, aliases + sizeof...(Args) + 1, true) !=
+                   aliases + sizeof...(Args) + 1;
         }
 
-        std::unique_ptr<ext::polymorphic_placeholder<T>> clone() const override
+        /*
+         * Functions operating on the contained object, one table per type.
+         * `copy` allocates from given resource, or from the resource of the
+         * source if it is null. `move` moves the object into the destination
+         * and destroys the source. Both return the address of the base
+         * subobject of the new object. `resource` returns the resource the
+         * object was allocated from, or null if it is local.
+         */
+        template<typename T, typename Buffer>
+        struct polymorphic_vtable
         {
-            return std::make_unique<polymorphic_holder>(*this);
-        }
+            T* (*copy)(Buffer const& source,
+                       Buffer& dest,
+                       ext::memory_resource* resource);
+            T* (*move)(Buffer& source, Buffer& dest) noexcept;
+            void (*destroy)(Buffer& storage) noexcept;
+            ext::memory_resource* (*resource)(Buffer const& storage) noexcept;
+        };
 
-        T& value() noexcept override
+        /*
+         * Heap-allocated object along with the resource it came from.
+         */
+        template<typename S>
+        struct polymorphic_heap_block
         {
-            return value_;
-        }
+            ext::memory_resource* resource;
+            S value;
 
-      private:
-        S value_;
-    };
+            template<typename... Args>
+            explicit
+            polymorphic_heap_block(ext::memory_resource* res, Args&&... args)
+                : resource {res}
+                , value(std::forward<Args>(args)...)
+            {
+            }
+        };
+
+        template<typename S,
+                 typename T,
+                 typename Buffer,
+                 bool Local>
+        struct polymorphic_handler;
+
+        template<typename S, typename T, typename Buffer>
+        struct polymorphic_handler<S, T, Buffer, true>
+        {
+            static S& get(Buffer& storage) noexcept
+            {
+                return *reinterpret_cast<S*>(&storage.buffer);
+            }
+
+            static S const& get(Buffer const& storage) noexcept
+            {
+                return *reinterpret_cast<S const*>(&storage.buffer);
+            }
+
+            template<typename... Args>
+            static T* create(Buffer& storage,
+                             ext::memory_resource*,
+                             Args&&... args)
+            {
+                return ::new(&storage.buffer) S(std::forward<Args>(args)...);
+            }
+
+            static T* copy(Buffer const& source,
+                           Buffer& dest,
+                           ext::memory_resource*)
+            {
+                return create(dest, nullptr, get(source));
+            }
+
+            static T* move(Buffer& source, Buffer& dest) noexcept
+            {
+                T* const ptr = create(dest, nullptr, std::move(get(source)));
+                destroy(source);
+                return ptr;
+            }
+
+            static void destroy(Buffer& storage) noexcept
+            {
+                get(storage).~S();
+            }
+
+            static ext::memory_resource* resource(Buffer const&) noexcept
+            {
+                return nullptr;
+            }
+
+            static S* object(Buffer& storage) noexcept
+            {
+                return &get(storage);
+            }
+
+            /*
+             * Replaces the object of type S with a new one in the same
+             * storage. The constructor must not throw.
+             */
+            template<typename... Args>
+            static T* reconstruct(Buffer& storage, Args&&... args) noexcept
+            {
+                destroy(storage);
+                return ::new(&storage.buffer) S(std::forward<Args>(args)...);
+            }
+        };
+
+        template<typename S, typename T, typename Buffer>
+        struct polymorphic_handler<S, T, Buffer, false>
+        {
+            using block = polymorphic_heap_block<S>;
+
+            static block* get(Buffer const& storage) noexcept
+            {
+                return static_cast<block*>(storage.heap);
+            }
+
+            template<typename... Args>
+            static T* create(Buffer& storage,
+                             ext::memory_resource* resource,
+                             Args&&... args)
+            {
+                auto const ptr = ext::new_object<block>(
+                    resource, resource, std::forward<Args>(args)...);
+                storage.heap = ptr;
+                return &ptr->value;
+            }
+
+            static T* copy(Buffer const& source,
+                           Buffer& dest,
+                           ext::memory_resource* resource)
+            {
+                auto const ptr = get(source);
+                return create(dest, resource ? resource : ptr->resource, ptr->value);
+            }
+
+            static T* move(Buffer& source, Buffer& dest) noexcept
+            {
+                dest.heap = source.heap;
+                return &get(dest)->value;
+            }
+
+            static void destroy(Buffer& storage) noexcept
+            {
+                auto const ptr = get(storage);
+                ext::delete_object(ptr->resource, ptr);
+            }
+
+            static ext::memory_resource* resource(Buffer const& storage) noexcept
+            {
+                return get(storage)->resource;
+            }
+
+            static S* object(Buffer& storage) noexcept
+            {
+                return &get(storage)->value;
+            }
+
+            /*
+             * Replaces the object of type S with a new one in the same
+             * block. The constructor must not throw.
+             */
+            template<typename... Args>
+            static T* reconstruct(Buffer& storage, Args&&... args) noexcept
+            {
+                auto const ptr = get(storage);
+                ptr->value.~S();
+                return ::new(&ptr->value) S(std::forward<Args>(args)...);
+            }
+        };
+
+        template<typename S, typename T, std::size_t Size, std::size_t Align>
+        struct polymorphic_vtable_of
+        {
+            using buffer = polymorphic_buffer<Size, Align>;
+            using handler = polymorphic_handler<
+                S, T, buffer, polymorphic_is_local<S, Size, Align>::value>;
+
+            static constexpr polymorphic_vtable<T, buffer> value = {
+                handler::copy,
+                handler::move,
+                handler::destroy,
+                handler::resource
+            };
+        };
+
+        template<typename S, typename T, std::size_t Size, std::size_t Align>
+        constexpr polymorphic_vtable<T, polymorphic_buffer<Size, Align>>
+        polymorphic_vtable_of<S, T, Size, Align>::value;
+
+        /*
+         * Representation of polymorphic_value with in-place storage. `ptr_`
+         * points to the base subobject of the contained object, and is null
+         * along with `vtable_` if there is no object.
+         */
+        template<typename T, std::size_t Size, std::size_t Align>
+        struct polymorphic_storage
+        {
+            polymorphic_storage() = default;
+
+            polymorphic_storage(polymorphic_storage const&) = delete;
+
+            polymorphic_storage& operator=(polymorphic_storage const&) = delete;
+
+            ~polymorphic_storage()
+            {
+                destroy();
+            }
+
+            /*
+             * Constructs an object of type S. There must be no object.
+             */
+            template<typename S, typename... Args>
+            void create(ext::memory_resource* resource, Args&&... args)
+            {
+                using vtable_of = polymorphic_vtable_of<S, T, Size, Align>;
+                using handler = typename vtable_of::handler;
+
+                ptr_ = handler::create(buffer_, resource, std::forward<Args>(args)...);
+                vtable_ = &vtable_of::value;
+            }
+
+            /*
+             * Returns the object if its dynamic type is exactly S, or null.
+             */
+            template<typename S>
+            S* find() noexcept
+            {
+                using vtable_of = polymorphic_vtable_of<S, T, Size, Align>;
+                using handler = typename vtable_of::handler;
+
+                if (vtable_ != &vtable_of::value)
+                    return nullptr;
+                return handler::object(buffer_);
+            }
+
+            /*
+             * Replaces the object with an object of type S. If the current
+             * object has type S, the constructor does not throw and args do
+             * not refer into the object, it is destroyed and the new one is
+             * constructed in its storage. Otherwise the new object is created
+             * first, allocating from given resource if it is not local.
+             */
+            template<typename S, typename... Args>
+            void emplace(ext::memory_resource* resource, Args&&... args)
+            {
+                using vtable_of = polymorphic_vtable_of<S, T, Size, Align>;
+                using handler = typename vtable_of::handler;
+
+                if (std::is_nothrow_constructible<S, Args&&...>::value &&
+                    vtable_ == &vtable_of::value &&
+                    !polymorphic_aliases(handler::object(buffer_), sizeof(S), args...))
+                {
+                    ptr_ = handler::reconstruct(buffer_, std::forward<Args>(args)...);
+                    return;
+                }
+
+                polymorphic_storage tmp;
+                tmp.template create<S>(resource, std::forward<Args>(args)...);
+                destroy();
+                move_from(tmp);
+            }
+
+            /*
+             * Copies the object of other. There must be no object.
+             */
+            void copy_from(polymorphic_storage const& other,
+                           ext::memory_resource* resource)
+            {
+                assert(other.vtable_);
+                ptr_ = other.vtable_->copy(other.buffer_, buffer_, resource);
+                vtable_ = other.vtable_;
+            }
+
+            /*
+             * Takes the object of other, which must be distinct from this.
+             * There must be no object. Local objects are moved, so the
+             * pointer to the base subobject is recomputed.
+             */
+            void move_from(polymorphic_storage& other) noexcept
+            {
+                if (other.vtable_)
+                {
+                    ptr_ = other.vtable_->move(other.buffer_, buffer_);
+                    vtable_ = other.vtable_;
+                    other.vtable_ = nullptr;
+                    other.ptr_ = nullptr;
+                }
+            }
+
+            void swap(polymorphic_storage& other) noexcept
+            {
+                polymorphic_storage tmp;
+                tmp.move_from(other);
+                other.move_from(*this);
+                move_from(tmp);
+            }
+
+            void destroy() noexcept
+            {
+                if (vtable_)
+                {
+                    vtable_->destroy(buffer_);
+                    vtable_ = nullptr;
+                    ptr_ = nullptr;
+                }
+            }
+
+            T* get() const noexcept
+            {
+                return ptr_;
+            }
+
+            /*
+             * Returns the resource the object was allocated from, or null if
+             * there is no object or it is local.
+             */
+            ext::memory_resource* resource() const noexcept
+            {
+                return vtable_ ? vtable_->resource(buffer_) : nullptr;
+            }
+
+          private:
+            using buffer_type = polymorphic_buffer<Size, Align>;
+
+            polymorphic_vtable<T, buffer_type> const* vtable_ = nullptr;
+            T* ptr_ = nullptr;
+            buffer_type buffer_;
+        };
+
+        //----------------------------------------------------------------------
+
+        template<typename T>
+        struct polymorphic_control;
+
+        /*
+         * Functions operating on a heap block, one table per type. `size`
+         * and `alignment` are those of the block. `base` returns the base
+         * subobject of the object; it is a function since the offset of a
+         * base class cannot be computed in a constant expression.
+         * `copy_into` constructs the copy in given storage of that size
+         * and alignment. `destruct` destroys the block without deallocating
+         * it, while `destroy` also deallocates.
+         */
+        template<typename T>
+        struct polymorphic_control_vtable
+        {
+            ext::type_id type;
+            std::size_t size;
+            std::size_t alignment;
+            T* (*base)(polymorphic_control<T>* control) noexcept;
+            polymorphic_control<T>* (*copy)(polymorphic_control<T> const& source,
+                                            ext::memory_resource* resource);
+            polymorphic_control<T>* (*copy_into)(polymorphic_control<T> const& source,
+                                                 void* storage,
+                                                 ext::memory_resource* resource);
+            void (*destruct)(polymorphic_control<T>* control) noexcept;
+            void (*destroy)(polymorphic_control<T>* control) noexcept;
+        };
+
+        /*
+         * Header of a heap block, which is followed by the object.
+         */
+        template<typename T>
+        struct polymorphic_control
+        {
+            polymorphic_control_vtable<T> const* vtable;
+            ext::memory_resource* resource;
+        };
+
+        template<typename S, typename T>
+        struct polymorphic_control_vtable_of;
+
+        template<typename S, typename T>
+        struct polymorphic_control_block : polymorphic_control<T>
+        {
+            S value;
+
+            template<typename... Args>
+            explicit
+            polymorphic_control_block(ext::memory_resource* res, Args&&... args)
+                : polymorphic_control<T> {
+                      &polymorphic_control_vtable_of<S, T>::value, res}
+                , value(std::forward<Args>(args)...)
+            {
+            }
+        };
+
+        template<typename S, typename T>
+        struct polymorphic_control_handler
+        {
+            using control = polymorphic_control<T>;
+            using block = polymorphic_control_block<S, T>;
+
+            template<typename... Args>
+            static control* create(ext::memory_resource* resource,
+                                   Args&&... args)
+            {
+                return ext::new_object<block>(
+                    resource, resource, std::forward<Args>(args)...);
+            }
+
+            static T* base(control* ctrl) noexcept
+            {
+                return &static_cast<block*>(ctrl)->value;
+            }
+
+            static control* copy(control const& source,
+                                 ext::memory_resource* resource)
+            {
+                auto const& src = static_cast<block const&>(source);
+                return create(resource ? resource : src.resource, src.value);
+            }
+
+            static control* copy_into(control const& source,
+                                      void* storage,
+                                      ext::memory_resource* resource)
+            {
+                auto const& src = static_cast<block const&>(source);
+                return ::new(storage) block(resource, src.value);
+            }
+
+            /*
+             * Destroys the block in ctrl, which must have the same size and
+             * alignment as blocks of S, and constructs a block of S in its
+             * storage. The constructor must not throw.
+             */
+            template<typename... Args>
+            static control* recreate(control* ctrl, Args&&... args) noexcept
+            {
+                assert(ctrl->vtable->size == sizeof(block));
+                assert(ctrl->vtable->alignment == alignof(block));
+
+                auto const resource = ctrl->resource;
+                ctrl->vtable->destruct(ctrl);
+
+                void* const storage = ctrl;
+                return ::new(storage) block(resource, std::forward<Args>(args)...);
+            }
+
+            static void destruct(control* ctrl) noexcept
+            {
+                static_cast<block*>(ctrl)->~block();
+            }
+
+            static void destroy(control* ctrl) noexcept
+            {
+                auto const ptr = static_cast<block*>(ctrl);
+                ext::delete_object(ptr->resource, ptr);
+            }
+        };
+
+        template<typename S, typename T>
+        struct polymorphic_control_vtable_of
+        {
+            using handler = polymorphic_control_handler<S, T>;
+            using block = typename handler::block;
+
+            static constexpr polymorphic_control_vtable<T> value = {
+                ext::type_id_of<S>(),
+                sizeof(block),
+                alignof(block),
+                handler::base,
+                handler::copy,
+                handler::copy_into,
+                handler::destruct,
+                handler::destroy
+            };
+        };
+
+        template<typename S, typename T>
+        constexpr polymorphic_control_vtable<T>
+        polymorphic_control_vtable_of<S, T>::value;
+
+        /*
+         * Representation of polymorphic_value without in-place storage: a
+         * single pointer to the heap block, which is null if there is no
+         * object.
+         */
+        template<typename T, std::size_t Align>
+        struct polymorphic_storage<T, 0, Align>
+        {
+            polymorphic_storage() = default;
+
+            polymorphic_storage(polymorphic_storage const&) = delete;
+
+            polymorphic_storage& operator=(polymorphic_storage const&) = delete;
+
+            ~polymorphic_storage()
+            {
+                destroy();
+            }
+
+            template<typename S, typename... Args>
+            void create(ext::memory_resource* resource, Args&&... args)
+            {
+                control_ = polymorphic_control_handler<S, T>::create(
+                    resource, std::forward<Args>(args)...);
+            }
+
+            template<typename S>
+            S* find() noexcept
+            {
+                using block = polymorphic_control_block<S, T>;
+
+                if (!control_ || control_->vtable->type != ext::type_id_of<S>())
+                    return nullptr;
+                return &static_cast<block*>(control_)->value;
+            }
+
+            /*
+             * Replaces the object with an object of type S. If the current
+             * block has the size and alignment of a block of S, the
+             * constructor does not throw and args do not refer into the
+             * block, the new object is constructed in it, keeping its
+             * resource. Otherwise a new block is allocated from given
+             * resource.
+             */
+            template<typename S, typename... Args>
+            void emplace(ext::memory_resource* resource, Args&&... args)
+            {
+                using handler = polymorphic_control_handler<S, T>;
+                using block = typename handler::block;
+
+                if (std::is_nothrow_constructible<S, Args&&...>::value &&
+                    control_ &&
+                    control_->vtable->size == sizeof(block) &&
+                    control_->vtable->alignment == alignof(block) &&
+                    !polymorphic_aliases(control_, sizeof(block), args...))
+                {
+                    control_ = handler::recreate(control_, std::forward<Args>(args)...);
+                    return;
+                }
+
+                auto const ctrl = handler::create(resource, std::forward<Args>(args)...);
+                destroy();
+                control_ = ctrl;
+            }
+
+            void copy_from(polymorphic_storage const& other,
+                           ext::memory_resource* resource)
+            {
+                assert(other.control_);
+                control_ = other.control_->vtable->copy(*other.control_, resource);
+            }
+
+            void move_from(polymorphic_storage& other) noexcept
+            {
+                control_ = other.control_;
+                other.control_ = nullptr;
+            }
+
+            void swap(polymorphic_storage& other) noexcept
+            {
+                std::swap(control_, other.control_);
+            }
+
+            void destroy() noexcept
+            {
+                if (control_)
+                {
+                    control_->vtable->destroy(control_);
+                    control_ = nullptr;
+                }
+            }
+
+            T* get() const noexcept
+            {
+                return control_->vtable->base(control_);
+            }
+
+            /*
+             * Returns the resource of the heap block, or null if there is no
+             * object.
+             */
+            ext::memory_resource* resource() const noexcept
+            {
+                return control_ ? control_->resource : nullptr;
+            }
+
+            /*
+             * Returns the table of the heap block, or null if there is no
+             * object.
+             */
+            polymorphic_control_vtable<T> const* vtable() const noexcept
+            {
+                return control_ ? control_->vtable : nullptr;
+            }
+
+            /*
+             * Copies the object of other into given storage, which must have
+             * the size and alignment of its block. There must be no object.
+             */
+            void copy_into(polymorphic_storage const& other,
+                           void* storage,
+                           ext::memory_resource* resource)
+            {
+                assert(other.control_);
+                control_ = other.control_->vtable->copy_into(
+                    *other.control_, storage, resource);
+            }
+
+          private:
+            polymorphic_control<T>* control_ = nullptr;
+        };
+    }
 
     //--------------------------------------------------------------------------
     // polymorhic_value
@@ -72,9 +706,40 @@ namespace ext
 
     /**
      * Holds polymorphic object in copy constructible way.
+     *
+     * The storage policy determines where the object lives. With
+     * `ext::inline_storage<Size, Align>`, small nothrow movable objects are
+     * stored in the polymorphic_value itself, so constructing and copying
+     * them does not allocate. Other objects are allocated from a memory
+     * resource, which is `ext::new_delete_resource()` unless specified
+     * otherwise. Copies allocate from the resource of the source, and
+     * replacement objects from the resource of the replaced one.
+     *
+     * With the default `ext::inline_storage<0>`, a polymorphic_value is a
+     * single pointer to a heap block whose header holds the function table
+     * and the resource.
+     *
+     * With `ext::closed_set<Ds...>`, the dynamic type is restricted to one of
+     * `Ds...` and the object is stored in place without any allocation.
+     *
+     * === Example ===
+     *
+     * ```
+     * // Strategies up to four pointers in size are stored in place.
+     * using strategy = ext::polymorphic_value<
+     *     pricing_strategy, ext::inline_storage<4 * sizeof(void*)>>;
+     * ```
      */
-    template<typename T>
-    struct polymorphic_value
+    template<typename T, typename Storage = ext::inline_storage<0>>
+    struct polymorphic_value;
+
+    namespace detail
+    {
+        struct polymorphic_bulk_access;
+    }
+
+    template<typename T, std::size_t Size, std::size_t Align>
+    struct polymorphic_value<T, ext::inline_storage<Size, Align>>
     {
         //----------------------------------------------------------------------
         // Constructors
@@ -83,13 +748,44 @@ namespace ext
         /**
          * Constructs an object with specified content.
          */
-        template<typename S>
+        template<typename S,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<S>, polymorphic_value>::value,
+                     int> = 0>
         polymorphic_value(S&& value)
-            : holder_ {std::make_unique<
-                        ext::polymorphic_holder<std::decay_t<S>, T>>(
-                            std::forward<S>(value))}
+            : polymorphic_value {std::allocator_arg,
+                                 ext::new_delete_resource(),
+                                 std::forward<S>(value)}
+        {
+        }
+
+        /**
+         * Constructs an object with specified content. If the content is not
+         * stored in place, it is allocated from given resource.
+         *
+         * Copies of the object allocate from the same resource, so the
+         * resource must outlive them as well.
+         */
+        template<typename S,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<S>, polymorphic_value>::value,
+                     int> = 0>
+        polymorphic_value(std::allocator_arg_t,
+                          ext::memory_resource* resource,
+                          S&& value)
+        {
+            create<std::decay_t<S>>(resource, std::forward<S>(value));
+        }
+
+        /**
+         * Copies content of `other` into a new instance allocated from given
+         * resource instead of the resource of `other`.
+         */
+        polymorphic_value(std::allocator_arg_t,
+                          ext::memory_resource* resource,
+                          polymorphic_value const& other)
         {
-            ptr_ = &holder_->value();
+            storage_.copy_from(other.storage_, resource);
         }
 
         //----------------------------------------------------------------------
@@ -100,20 +796,17 @@ namespace ext
          * Copies content of `other` into a new instance.
          */
         polymorphic_value(polymorphic_value const& other)
-            : holder_ {other.holder_->clone()}
-        {
-            ptr_ = &holder_->value();
-        }
-
-        polymorphic_value(polymorphic_value& other)
-            : polymorphic_value {const_cast<polymorphic_value const&>(other)}
         {
+            storage_.copy_from(other.storage_, nullptr);
         }
 
         /**
          * Moves content of other into a new instance.
          */
-        polymorphic_value(polymorphic_value&&) = default;
+        polymorphic_value(polymorphic_value&& other) noexcept
+        {
+            storage_.move_from(other.storage_);
+        }
 
         /**
          * Copies content of other into object, replacing old one.
@@ -124,15 +817,18 @@ namespace ext
             return *this;
         }
 
-        polymorphic_value& operator=(polymorphic_value& other)
-        {
-            return (*this = const_cast<polymorphic_value const&>(other));
-        }
-
         /**
          * Moves content of other into object, replacing old one.
          */
-        polymorphic_value& operator=(polymorphic_value&&) = default;
+        polymorphic_value& operator=(polymorphic_value&& other) noexcept
+        {
+            if (this != &other)
+            {
+                storage_.destroy();
+                storage_.move_from(other.storage_);
+            }
+            return *this;
+        }
 
         /**
          * Destroys the content, if any.
@@ -145,23 +841,46 @@ namespace ext
 
         /**
          * Replaces the contained object with the right-hand side.
+         *
+         * If the contained object has the same type, the right-hand side is
+         * assigned to it. Otherwise this works as `emplace`.
          */
-        template<typename S>
+        template<typename S,
+                 std::enable_if_t<
+                     !std::is_same<std::decay_t<S>, polymorphic_value>::value,
+                     int> = 0>
         polymorphic_value& operator=(S&& value)
         {
-            polymorphic_value {std::forward<S>(value)}.swap(*this);
+            using type = std::decay_t<S>;
+            assign<type>(std::is_assignable<type&, S&&> {}, std::forward<S>(value));
             return *this;
         }
 
         /**
          * Replaces the contained object with newly constructed object.
+         *
+         * The storage of the contained object is reused without allocation
+         * if it has the same type as the new one, or, with the default
+         * storage policy, if its heap block has the same size and alignment.
+         * The reused block stays in its memory resource. Storage is reused
+         * only if the constructor cannot throw and the arguments do not
+         * refer into the contained object, so the contained object is kept
+         * if the constructor throws.
+         *
+         * A new object that is not stored in place is allocated from the
+         * resource of the contained object, or `ext::new_delete_resource()`
+         * if there is no object or it is stored in place.
          */
         template<typename S, typename... Args>
         void emplace(Args&&... args)
         {
-            holder_ = std::make_unique<ext::polymorphic_holder<S, T>>(
-                    std::forward<Args>(args)...);
-            ptr_ = &holder_->value();
+            static_assert(std::is_copy_constructible<S>::value,
+                          "contained type must be copy constructible");
+
+            auto const resource = storage_.resource();
+            storage_.template emplace<S>(
+                resource ? resource : ext::new_delete_resource(),
+                std::forward<Args>(args)...);
         }
 
         /**
@@ -169,8 +888,7 @@ namespace ext
          */
         void swap(polymorphic_value& other) noexcept
         {
-            std::swap(ptr_, other.ptr_);
-            std::swap(holder_, other.holder_);
+            storage_.swap(other.storage_);
         }
 
         //----------------------------------------------------------------------
@@ -185,12 +903,12 @@ namespace ext
          */
         T& value() noexcept
         {
-            return *ptr_;
+            return *storage_.get();
         }
 
         T const& value() const noexcept
         {
-            return *ptr_;
+            return *storage_.get();
         }
 
         /**
@@ -206,13 +924,13 @@ namespace ext
         template<typename S>
         S& as()
         {
-            return static_cast<S&>(*ptr_);
+            return static_cast<S&>(*storage_.get());
         }
 
         template<typename S>
         S const& as() const
         {
-            return static_cast<S&>(*ptr_);
+            return static_cast<S&>(*storage_.get());
         }
 
         /**
@@ -223,18 +941,398 @@ namespace ext
          */
         T* operator->() noexcept
         {
-            return ptr_;
+            return storage_.get();
         }
 
         T const* operator->() const noexcept
         {
-            return ptr_;
+            return storage_.get();
         }
 
         //----------------------------------------------------------------------
       private:
-        T* ptr_;
-        std::unique_ptr<ext::polymorphic_placeholder<T>> holder_;
+        template<typename S, typename U>
+        void assign(std::true_type, U&& value)
+        {
+            if (S* const object = storage_.template find<S>())
+                *object = std::forward<U>(value);
+            else
+                emplace<S>(std::forward<U>(value));
+        }
+
+        template<typename S, typename U>
+        void assign(std::false_type, U&& value)
+        {
+            emplace<S>(std::forward<U>(value));
+        }
+
+        friend struct detail::polymorphic_bulk_access;
+
+        /*
+         * Constructs an empty object, which is only used internally as the
+         * destination of bulk clone.
+         */
+        polymorphic_value() = default;
+
+        template<typename S, typename... Args>
+        void create(ext::memory_resource* resource, Args&&... args)
+        {
+            static_assert(std::is_copy_constructible<S>::value,
+                          "contained type must be copy constructible");
+
+            storage_.template create<S>(resource, std::forward<Args>(args)...);
+        }
+
+        detail::polymorphic_storage<T, Size, Align> storage_;
+    };
+
+    //--------------------------------------------------------------------------
+    // Closed set of types
+    //--------------------------------------------------------------------------
+
+    namespace detail
+    {
+        /*
+         * Position of S in Ds..., or the number of types if S is not there.
+         */
+        template<typename S, typename... Ds>
+        struct closed_set_index;
+
+        template<typename S>
+        struct closed_set_index<S> : std::integral_constant<std::size_t, 0>
+        {
+        };
+
+        template<typename S, typename D, typename... Ds>
+        struct closed_set_index<S, D, Ds...> : std::integral_constant<
+            std::size_t,
+            std::is_same<S, D>::value ? 0 : 1 + closed_set_index<S, Ds...>::value>
+        {
+        };
+
+        template<typename S, typename... Ds>
+        struct closed_set_contains : std::integral_constant<bool,
+            closed_set_index<S, Ds...>::value < sizeof...(Ds)>
+        {
+        };
+
+        constexpr
+        bool closed_set_all(std::initializer_list<bool> conditions)
+        {
+            for (bool condition : conditions)
+            {
+                if (!condition)
+                    return false;
+            }
+            return true;
+        }
+
+        /*
+         * Calls `fun(static_cast<D*>(nullptr))` where D is the index-th type
+         * of Ds. The chain of comparisons compiles to a switch.
+         */
+        template<std::size_t I, typename... Ds>
+        struct closed_set_dispatch;
+
+        template<std::size_t I, typename D>
+        struct closed_set_dispatch<I, D>
+        {
+            template<typename F>
+            static decltype(auto) apply(std::size_t index, F&& fun)
+            {
+                assert(index == I);
+                static_cast<void>(index);
+                return fun(static_cast<D*>(nullptr));
+            }
+        };
+
+        template<std::size_t I, typename D, typename... Ds>
+        struct closed_set_dispatch<I, D, Ds...>
+        {
+            template<typename F>
+            static decltype(auto) apply(std::size_t index, F&& fun)
+            {
+                if (index == I)
+                    return fun(static_cast<D*>(nullptr));
+                return closed_set_dispatch<I + 1, Ds...>::apply(index, fun);
+            }
+        };
+    }
+
+    /**
+     * Polymorphic value whose dynamic type is one of `Ds...`.
+     *
+     * The object is stored in an aligned buffer large enough for every type
+     * in the set, along with the index of its type. Copy, move and
+     * destruction branch on the index, so no operation allocates or goes
+     * through a function pointer. The memory resource constructors are not
+     * provided.
+     *
+     * Every type in the set must be derived from T and nothrow move
+     * constructible. A moved-out object holds the moved-out contained object.
+     *
+     * === Example ===
+     *
+     * ```
+     * using shape_value = ext::polymorphic_value<
+     *     shape, ext::closed_set<circle, square, triangle>>;
+     * std::vector<shape_value> shapes;
+     * shapes.emplace_back(circle {1.0});
+     * ```
+     */
+    template<typename T, typename... Ds>
+    struct polymorphic_value<T, ext::closed_set<Ds...>>
+    {
+        static_assert(sizeof...(Ds) > 0,
+                      "closed set must have at least one type");
+        static_assert(sizeof...(Ds) <= 256,
+                      "closed set must have at most 256 types");
+        static_assert(detail::closed_set_all({std::is_base_of<T, Ds>::value...}),
+                      "types in closed set must be derived from the base type");
+        static_assert(detail::closed_set_all(
+                          {std::is_nothrow_move_constructible<Ds>::value...}),
+                      "types in closed set must be nothrow move constructible");
+
+        //----------------------------------------------------------------------
+        // Constructors
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs an object with specified content, whose type must be
+         * one of `Ds...`.
+         */
+        template<typename S,
+                 std::enable_if_t<
+                     detail::closed_set_contains<std::decay_t<S>, Ds...>::value,
+                     int> = 0>
+        polymorphic_value(S&& value)
+        {
+            construct<std::decay_t<S>>(std::forward<S>(value));
+        }
+
+        //----------------------------------------------------------------------
+        // Special member functions
+        //----------------------------------------------------------------------
+
+        /**
+         * Copies content of `other` into a new instance.
+         */
+        polymorphic_value(polymorphic_value const& other)
+        {
+            dispatch(other.index_, [&](auto tag) {
+                using type = std::remove_pointer_t<decltype(tag)>;
+                this->template construct<type>(other.template get<type>());
+            });
+        }
+
+        /**
+         * Moves content of other into a new instance.
+         */
+        polymorphic_value(polymorphic_value&& other) noexcept
+        {
+            move_from(other);
+        }
+
+        /**
+         * Copies content of other into object, replacing old one.
+         */
+        polymorphic_value& operator=(polymorphic_value const& other)
+        {
+            if (this != &other)
+                *this = polymorphic_value {other};
+            return *this;
+        }
+
+        /**
+         * Moves content of other into object, replacing old one.
+         */
+        polymorphic_value& operator=(polymorphic_value&& other) noexcept
+        {
+            if (this != &other)
+            {
+                destroy();
+                move_from(other);
+            }
+            return *this;
+        }
+
+        /**
+         * Destroys the content.
+         */
+        ~polymorphic_value()
+        {
+            destroy();
+        }
+
+        //----------------------------------------------------------------------
+        // Modifiers
+        //----------------------------------------------------------------------
+
+        /**
+         * Replaces the contained object with the right-hand side. If the
+         * contained object has the same type, the right-hand side is assigned
+         * to it.
+         */
+        template<typename S,
+                 std::enable_if_t<
+                     detail::closed_set_contains<std::decay_t<S>, Ds...>::value,
+                     int> = 0>
+        polymorphic_value& operator=(S&& value)
+        {
+            using type = std::decay_t<S>;
+            assign<type>(std::is_assignable<type&, S&&> {}, std::forward<S>(value));
+            return *this;
+        }
+
+        /**
+         * Replaces the contained object with newly constructed object.
+         */
+        template<typename S, typename... Args>
+        void emplace(Args&&... args)
+        {
+            static_assert(detail::closed_set_contains<S, Ds...>::value,
+                          "type must be in the closed set");
+
+            S value(std::forward<Args>(args)...);
+            destroy();
+            construct<S>(std::move(value));
+        }
+
+        /**
+         * Swaps contained objects.
+         */
+        void swap(polymorphic_value& other) noexcept
+        {
+            polymorphic_value tmp {std::move(other)};
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        //----------------------------------------------------------------------
+        // Observers
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the position of the type of the contained object in
+         * `Ds...`.
+         */
+        std::size_t index() const noexcept
+        {
+            return index_;
+        }
+
+        /**
+         * Accesses contained object.
+         */
+        T& value() noexcept
+        {
+            return dispatch(index_, [this](auto tag) -> T& {
+                return this->template get<std::remove_pointer_t<decltype(tag)>>();
+            });
+        }
+
+        T const& value() const noexcept
+        {
+            return dispatch(index_, [this](auto tag) -> T const& {
+                return this->template get<std::remove_pointer_t<decltype(tag)>>();
+            });
+        }
+
+        /**
+         * Accesses contained object as type S.
+         *
+         * This function does not check the dynamic type. Behaviour is undefined
+         * if the dynamic type of the contained object is not `S` or a subclass
+         * of `S`.
+         */
+        template<typename S>
+        S& as()
+        {
+            return static_cast<S&>(value());
+        }
+
+        template<typename S>
+        S const& as() const
+        {
+            return static_cast<S const&>(value());
+        }
+
+        /**
+         * Accesses member of contained object.
+         */
+        T* operator->() noexcept
+        {
+            return &value();
+        }
+
+        T const* operator->() const noexcept
+        {
+            return &value();
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        template<typename S, typename U>
+        void assign(std::true_type, U&& value)
+        {
+            if (index_ == detail::closed_set_index<S, Ds...>::value)
+                get<S>() = std::forward<U>(value);
+            else
+                *this = polymorphic_value {std::forward<U>(value)};
+        }
+
+        template<typename S, typename U>
+        void assign(std::false_type, U&& value)
+        {
+            *this = polymorphic_value {std::forward<U>(value)};
+        }
+
+        template<typename F>
+        static decltype(auto) dispatch(std::size_t index, F&& fun)
+        {
+            return detail::closed_set_dispatch<0, Ds...>::apply(
+                index, std::forward<F>(fun));
+        }
+
+        template<typename S>
+        S& get() noexcept
+        {
+            return *reinterpret_cast<S*>(&storage_);
+        }
+
+        template<typename S>
+        S const& get() const noexcept
+        {
+            return *reinterpret_cast<S const*>(&storage_);
+        }
+
+        template<typename S, typename... Args>
+        void construct(Args&&... args)
+        {
+            ::new(&storage_) S(std::forward<Args>(args)...);
+            index_ = static_cast<unsigned char>(
+                detail::closed_set_index<S, Ds...>::value);
+        }
+
+        void move_from(polymorphic_value& other) noexcept
+        {
+            dispatch(other.index_, [&](auto tag) {
+                using type = std::remove_pointer_t<decltype(tag)>;
+                this->template construct<type>(std::move(other.template get<type>()));
+            });
+        }
+
+        void destroy() noexcept
+        {
+            dispatch(index_, [this](auto tag) {
+                using type = std::remove_pointer_t<decltype(tag)>;
+                this->template get<type>().~type();
+            });
+        }
+
+        std::aligned_storage_t<std::max({sizeof(Ds)...}),
+                               std::max({alignof(Ds)...})> storage_;
+        unsigned char index_;
     };
 
     /**
@@ -243,19 +1341,112 @@ namespace ext
      * Comparison is done by `operator==` overloaded for the base type `T`, not
      * the dynamic type of the contents of the operands.
      */
-    template<typename T>
-    bool operator==(ext::polymorphic_value<T> const& a,
-                    ext::polymorphic_value<T> const& b)
+    template<typename T, typename Storage>
+    bool operator==(ext::polymorphic_value<T, Storage> const& a,
+                    ext::polymorphic_value<T, Storage> const& b)
     {
         return a.value() == b.value();
     }
 
-    template<typename T>
-    bool operator!=(ext::polymorphic_value<T> const& a,
-                    ext::polymorphic_value<T> const& b)
+    template<typename T, typename Storage>
+    bool operator!=(ext::polymorphic_value<T, Storage> const& a,
+                    ext::polymorphic_value<T, Storage> const& b)
     {
         return !(a == b);
     }
+
+    //--------------------------------------------------------------------------
+    // Bulk cloning
+    //--------------------------------------------------------------------------
+
+    namespace detail
+    {
+        struct polymorphic_bulk_access
+        {
+            template<typename T>
+            static auto vtable(ext::polymorphic_value<T> const& value) noexcept
+            {
+                return value.storage_.vtable();
+            }
+
+            template<typename T>
+            static ext::polymorphic_value<T>
+            copy_into(ext::polymorphic_value<T> const& value,
+                      void* storage,
+                      ext::memory_resource* resource)
+            {
+                ext::polymorphic_value<T> copy;
+                copy.storage_.copy_into(value.storage_, storage, resource);
+                return copy;
+            }
+        };
+
+        inline
+        std::size_t polymorphic_align_up(std::size_t offset,
+                                         std::size_t alignment) noexcept
+        {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    /**
+     * Copies the polymorphic values in `[first, last)` to `out`, placing all
+     * the copies in a single block taken from given arena.
+     *
+     * The block is sized up front from the block sizes and alignments kept
+     * in the function tables of the values, so copying a container costs one
+     * request to the arena instead of one allocation per value. The copies
+     * refer to the arena as their resource: destroying them gives nothing
+     * back until the arena is released, and copies of them allocate from
+     * the arena. The arena must outlive the copies.
+     *
+     * Only the default storage policy is supported. Behaviour is undefined
+     * if a value is moved out.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::monotonic_buffer_resource arena;
+     * std::vector<ext::polymorphic_value<shape>> snapshot;
+     * snapshot.reserve(shapes.size());
+     * ext::bulk_clone(shapes.begin(), shapes.end(),
+     *                 std::back_inserter(snapshot), arena);
+     * ```
+     */
+    template<typename ForwardIt, typename OutputIt>
+    OutputIt bulk_clone(ForwardIt first,
+                        ForwardIt last,
+                        OutputIt out,
+                        ext::monotonic_buffer_resource& arena)
+    {
+        using access = detail::polymorphic_bulk_access;
+
+        std::size_t total = 0;
+        std::size_t alignment = 1;
+        for (auto it = first; it != last; ++it)
+        {
+            auto const vtable = access::vtable(*it);
+            assert(vtable);
+            total = detail::polymorphic_align_up(total, vtable->alignment);
+            total += vtable->size;
+            alignment = std::max(alignment, vtable->alignment);
+        }
+
+        if (total == 0)
+            return out;
+
+        auto const block = static_cast<char*>(arena.allocate(total, alignment));
+        std::size_t offset = 0;
+        for (; first != last; ++first)
+        {
+            auto const vtable = access::vtable(*first);
+            offset = detail::polymorphic_align_up(offset, vtable->alignment);
+            *out = access::copy_into(*first, block + offset, &arena);
+            ++out;
+            offset += vtable->size;
+        }
+        return out;
+    }
 }
 
 #endif
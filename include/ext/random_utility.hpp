@@ -14,7 +14,11 @@
 #include <type_traits>
 #include <utility>
 
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+
+#include "array_view.hpp"
 
 namespace ext
 {
@@ -43,8 +47,133 @@ namespace ext
     {
     };
 
+    namespace detail
+    {
+        /*
+         * Number of 32-bit seed values generated by a single call to the
+         * seed sequence in `ext::seed_state`.
+         */
+        constexpr std::size_t seed_chunk_size = 256;
+
+        /*
+         * Finalizer of MurmurHash3. This is a bijection on 32-bit words with
+         * good avalanche.
+         */
+        inline
+        std::uint32_t mix32(std::uint32_t x) noexcept
+        {
+            x ^= x >> 16;
+            x *= 0x85ebca6bu;
+            x ^= x >> 13;
+            x *= 0xc2b2ae35u;
+            x ^= x >> 16;
+            return x;
+        }
+
+        /*
+         * Packs consecutive 32-bit seed values into words of the state.
+         */
+        template<typename R, typename T>
+        void pack_seeds(R const* seeds, ext::array_view<T> state)
+        {
+            constexpr std::size_t word_bits = std::numeric_limits<T>::digits;
+            constexpr std::size_t seed_per_word = (word_bits + 31) / 32;
+            constexpr std::size_t shift_bits = std::min<std::size_t>(word_bits, 32);
+
+            for (auto& word : state)
+            {
+                T value = 0;
+                for (std::size_t j = 0; j < seed_per_word; ++j)
+                    value = T(T(value << 1 << (shift_bits - 1)) | *seeds++);
+                word = value;
+            }
+        }
+
+        /*
+         * Generates count words of seed values as `ext::seed_state` does,
+         * calling `sink(offset, words)` for each chunk of at most
+         * `seed_chunk_size` 32-bit values instead of storing them.
+         */
+        template<typename T, typename Seed, typename Sink>
+        void generate_seed_words(Seed& seed, std::size_t count, Sink&& sink)
+        {
+            static_assert(ext::is_seed_sequence<Seed>::value,
+                          "seed is expected to be a SeedSequence");
+
+            static_assert(std::is_unsigned<T>::value,
+                          "state is expected to be array of unsigned integers");
+
+            // Note: Conforming seed sequence generates 32-bit unsigned integers.
+            using seed_type = typename Seed::result_type;
+            constexpr std::size_t word_bits = std::numeric_limits<T>::digits;
+            constexpr std::size_t seed_per_word = (word_bits + 31) / 32;
+            constexpr std::size_t chunk_size = detail::seed_chunk_size;
+            constexpr std::size_t words_per_chunk = chunk_size / seed_per_word;
+
+            static_assert(words_per_chunk > 0, "word type is too wide");
+
+            std::array<seed_type, chunk_size> seeds;
+            std::array<T, words_per_chunk> words;
+
+            if (count <= words_per_chunk)
+            {
+                seed.generate(seeds.begin(), seeds.begin() + count * seed_per_word);
+                ext::array_view<T> const view {words.data(), count};
+                detail::pack_seeds(seeds.data(), view);
+                sink(std::size_t(0), ext::array_view<T const>(view));
+                return;
+            }
+
+            std::array<seed_type, chunk_size> key;
+            seed.generate(key.begin(), key.end());
+
+            for (std::size_t start = 0, chunk = 0; start < count;
+                 start += words_per_chunk, ++chunk)
+            {
+                auto const end = std::min(start + words_per_chunk, count);
+                auto const salt = detail::mix32(
+                    std::uint32_t(chunk) ^ detail::mix32(std::uint32_t(chunk >> 16 >> 16)));
+
+                for (std::size_t i = 0; i < chunk_size; ++i)
+                    seeds[i] = detail::mix32(std::uint32_t(key[i]) ^ salt);
+
+                ext::array_view<T> const view {words.data(), end - start};
+                detail::pack_seeds(seeds.data(), view);
+                sink(start, ext::array_view<T const>(view));
+            }
+        }
+    }
+
     /**
      * Fills array with seed values.
+     *
+     * Each word of the state receives as many 32-bit values from the seed
+     * sequence as needed to fill its bits.
+     *
+     * For states up to `detail::seed_chunk_size` 32-bit values the seed
+     * sequence is asked to generate all the values at once. For larger states
+     * the seed sequence generates a key of that size once, and the state is
+     * filled chunk by chunk with the key hashed with the chunk index. So the
+     * memory used does not depend on the size of the state, and states of
+     * millions of words can be seeded without temporary arrays.
+     */
+    template<typename Seed, typename T>
+    void seed_state(Seed& seed, ext::array_view<T> state)
+    {
+        detail::generate_seed_words<T>(
+            seed, state.size(),
+            [&](std::size_t offset, ext::array_view<T const> words) {
+                std::copy(words.begin(), words.end(), state.begin() + offset);
+            });
+    }
+
+    /**
+     * Fills `std::array` with seed values.
+     *
+     * Unlike the `array_view` overload, the seed sequence generates all the
+     * values at once into a temporary array of the size of the state. Both
+     * give the same state if it takes at most `detail::seed_chunk_size`
+     * 32-bit values.
      */
     template<typename Seed, typename T, std::size_t N>
     void seed_state(Seed& seed, std::array<T, N>& state)
@@ -58,20 +187,72 @@ namespace ext
         // Note: Conforming seed sequence generates 32-bit unsigned integers.
         constexpr std::size_t word_bits = std::numeric_limits<T>::digits;
         constexpr std::size_t seed_per_word = (word_bits + 31) / 32;
-        constexpr std::size_t shift_bits = std::min<std::size_t>(word_bits, 32);
 
         std::array<typename Seed::result_type, N * seed_per_word> seeds;
         seed.generate(seeds.begin(), seeds.end());
+        detail::pack_seeds(seeds.data(), ext::array_view<T>(state));
+    }
 
-        for (std::size_t i = 0; i < N; ++i)
-        {
-            state[i] = 0;
-            for (std::size_t j = 0; j < seed_per_word; ++j)
-            {
-                state[i] = T(state[i] << 1 << (shift_bits - 1));
-                state[i] = T(state[i] | seeds[i * seed_per_word + j]);
-            }
-        }
+    /**
+     * Computes the quantile function of the standard normal distribution.
+     *
+     * This function maps uniform values to normal values by inversion, which
+     * is what quasi-random points need as they have to be transformed one to
+     * one. The implementation uses Acklam's rational approximation [1] with
+     * relative error less than 1.15e-9.
+     *
+     * Returns negative infinity for 0 and positive infinity for 1. Behaviour
+     * is undefined if `p` is out of [0, 1].
+     *
+     * [1]: P. J. Acklam, "An algorithm for computing the inverse normal
+     *      cumulative distribution function" (2003).
+     */
+    inline
+    double normal_quantile(double p)
+    {
+        static constexpr double a[] = {
+            -3.969683028665376e+01,  2.209460984245205e+02,
+            -2.759285104469687e+02,  1.383577518672690e+02,
+            -3.066479806614716e+01,  2.506628277459239e+00
+        };
+        static constexpr double b[] = {
+            -5.447609879822406e+01,  1.615858368580409e+02,
+            -1.556989798598866e+02,  6.680131188771972e+01,
+            -1.328068155288572e+01
+        };
+        static constexpr double c[] = {
+            -7.784894002430293e-03, -3.223964580411365e-01,
+            -2.400758277161838e+00, -2.549732539343734e+00,
+             4.374664141464968e+00,  2.938163982698783e+00
+        };
+        static constexpr double d[] = {
+             7.784695709041462e-03,  3.224671290700398e-01,
+             2.445134137142996e+00,  3.754408661907416e+00
+        };
+        static constexpr double p_low = 0.02425;
+
+        auto const tail = [](double q) {
+            double const t = std::sqrt(-2 * std::log(q));
+            return (((((c[0] * t + c[1]) * t + c[2]) * t + c[3]) * t + c[4]) * t + c[5])
+                   / ((((d[0] * t + d[1]) * t + d[2]) * t + d[3]) * t + 1);
+        };
+
+        if (p <= 0)
+            return -std::numeric_limits<double>::infinity();
+
+        if (p >= 1)
+            return std::numeric_limits<double>::infinity();
+
+        if (p < p_low)
+            return tail(p);
+
+        if (p > 1 - p_low)
+            return -tail(1 - p);
+
+        double const q = p - 0.5;
+        double const r = q * q;
+        return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q
+               / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
     }
 }
 
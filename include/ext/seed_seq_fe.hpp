@@ -0,0 +1,212 @@
+/*
+ * Fixed-entropy seed sequence without dynamic allocation.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_SEED_SEQ_FE_HPP
+#define EXT_SEED_SEQ_FE_HPP
+
+#include <initializer_list>
+#include <type_traits>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "array_view.hpp"
+
+namespace ext
+{
+    /**
+     * SeedSequence that stores N 32-bit words of entropy in place.
+     *
+     * Unlike `std::seed_seq`, which copies all of its input into a vector,
+     * this class hashes the input into a fixed-size pool on construction and
+     * never allocates. Every input word affects every pool word. Each
+     * generated word is a hash of a single pool word, taken in turn, so it
+     * depends on all input but only on one pool word. The mixing functions
+     * follow `seed_seq_fe` of randutils [1].
+     *
+     * Construction and generation are usable in constant expressions.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::seed_seq_fe<4> seed {request_id, worker_id};
+     * ext::sfc64 engine {seed};
+     * ```
+     *
+     * [1]: http://www.pcg-random.org/posts/simple-portable-cpp-seed-entropy.html
+     */
+    template<std::size_t N>
+    struct seed_seq_fe
+    {
+        static_assert(N > 0, "entropy pool must not be empty");
+
+        using result_type = std::uint32_t;
+
+        //----------------------------------------------------------------------
+        // Construction
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs a seed sequence with no input.
+         */
+        constexpr
+        seed_seq_fe() noexcept
+        {
+            int const* const none = nullptr;
+            mix_entropy(none, none);
+        }
+
+        /**
+         * Constructs a seed sequence from integers in the list. Only the
+         * lower 32 bits of each integer are used.
+         */
+        template<typename T,
+                 std::enable_if_t<std::is_integral<T>::value, int> = 0>
+        constexpr
+        seed_seq_fe(std::initializer_list<T> values) noexcept
+        {
+            mix_entropy(values.begin(), values.end());
+        }
+
+        /**
+         * Constructs a seed sequence from integers in the range. Only the
+         * lower 32 bits of each integer are used.
+         */
+        template<typename InputIterator>
+        constexpr
+        seed_seq_fe(InputIterator first, InputIterator last)
+        {
+            mix_entropy(first, last);
+        }
+
+        //----------------------------------------------------------------------
+        // SeedSequence interface
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the number of words in the entropy pool.
+         */
+        static constexpr
+        std::size_t size() noexcept
+        {
+            return N;
+        }
+
+        /**
+         * Fills the range with 32-bit seed values derived from the pool.
+         */
+        template<typename RandomAccessIterator>
+        constexpr
+        void generate(RandomAccessIterator first, RandomAccessIterator last) const
+        {
+            result_type hash_const = init_b;
+            std::size_t src = 0;
+
+            for (; first != last; ++first)
+            {
+                result_type value = pool_[src];
+                if (++src == N)
+                    src = 0;
+
+                value ^= hash_const;
+                hash_const = result_type(hash_const * mult_b);
+                value = result_type(value * hash_const);
+                value ^= value >> shift;
+                *first = value;
+            }
+        }
+
+        /**
+         * Fills the view with 32-bit seed values derived from the pool.
+         */
+        void generate(ext::array_view<result_type> output) const
+        {
+            generate(output.begin(), output.end());
+        }
+
+        /**
+         * Copies out the entropy pool.
+         *
+         * Note that the pool is the hashed input, so constructing another
+         * seed sequence from it does not reproduce this one.
+         */
+        template<typename OutputIterator>
+        void param(OutputIterator dest) const
+        {
+            for (std::size_t i = 0; i < N; ++i)
+                *dest++ = pool_[i];
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        static constexpr result_type init_a = 0x43b0d7e5;
+        static constexpr result_type mult_a = 0x931e8875;
+        static constexpr result_type init_b = 0x8b51f9dd;
+        static constexpr result_type mult_b = 0x58f38ded;
+        static constexpr result_type mix_mult_l = 0xca01f9dd;
+        static constexpr result_type mix_mult_r = 0x4973f715;
+        static constexpr unsigned shift = 16;
+
+        static constexpr
+        result_type hash(result_type value, result_type& hash_const) noexcept
+        {
+            value ^= hash_const;
+            hash_const = result_type(hash_const * mult_a);
+            value = result_type(value * hash_const);
+            value ^= value >> shift;
+            return value;
+        }
+
+        static constexpr
+        result_type mix(result_type x, result_type y) noexcept
+        {
+            auto result = result_type(mix_mult_l * x - mix_mult_r * y);
+            result ^= result >> shift;
+            return result;
+        }
+
+        template<typename InputIterator>
+        constexpr
+        void mix_entropy(InputIterator first, InputIterator last)
+        {
+            result_type hash_const = init_a;
+
+            // Hash the first N inputs, padding with zeros.
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                result_type value = 0;
+                if (first != last)
+                {
+                    value = static_cast<result_type>(*first);
+                    ++first;
+                }
+                pool_[i] = hash(value, hash_const);
+            }
+
+            // Let every pool word affect every other.
+            for (std::size_t src = 0; src < N; ++src)
+            {
+                for (std::size_t dest = 0; dest < N; ++dest)
+                {
+                    if (src != dest)
+                        pool_[dest] = mix(pool_[dest], hash(pool_[src], hash_const));
+                }
+            }
+
+            // Fold the remaining inputs into every pool word.
+            for (; first != last; ++first)
+            {
+                auto const value = static_cast<result_type>(*first);
+                for (std::size_t dest = 0; dest < N; ++dest)
+                    pool_[dest] = mix(pool_[dest], hash(value, hash_const));
+            }
+        }
+
+        result_type pool_[N] = {};
+    };
+}
+
+#endif
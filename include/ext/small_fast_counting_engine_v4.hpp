@@ -260,6 +260,9 @@ namespace ext
 
         //----------------------------------------------------------------------
       private:
+        template<typename>
+        friend struct engine_array;
+
         result_type state_a_ = 0;
         result_type state_b_ = 0;
         result_type state_c_ = 0;
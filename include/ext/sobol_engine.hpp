@@ -0,0 +1,436 @@
+/*
+ * Sobol low-discrepancy sequence.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_SOBOL_ENGINE_HPP
+#define EXT_SOBOL_ENGINE_HPP
+
+#include <random>
+#include <vector>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "array_view.hpp"
+#include "bit_utility.hpp"
+
+namespace ext
+{
+    /**
+     * Randomization applied to the points of `ext::sobol_engine`.
+     */
+    enum class sobol_scrambling
+    {
+        /**
+         * Points are not randomized.
+         */
+        none,
+
+        /**
+         * Each coordinate is XORed with a random word. This keeps the
+         * (t, s)-net properties and is the cheapest randomization.
+         */
+        digital_shift,
+
+        /**
+         * Each coordinate is permuted by a random nested uniform (Owen)
+         * scramble, implemented with a hash [1]. This keeps the net
+         * properties and improves the convergence rate for smooth
+         * integrands.
+         *
+         * [1]: B. Burley, "Practical Hash-based Owen Scrambling", Journal of
+         *      Computer Graphics Techniques 9 (2020) 1-20.
+         */
+        owen
+    };
+
+    template<typename Dummy = void>
+    struct sobol_tables
+    {
+        struct entry
+        {
+            unsigned degree;
+            unsigned polynomial;
+            unsigned initial[8];
+        };
+
+        /*
+         * Primitive polynomials and initial direction numbers for dimensions
+         * 2 and up, taken from new-joe-kuo-6.21201 [1]. The polynomial field
+         * holds the coefficients of the middle terms.
+         *
+         * [1]: http://web.maths.unsw.edu.au/~fkuo/sobol/
+         */
+        static constexpr std::size_t size = 39;
+        static entry const entries[size];
+    };
+
+    /**
+     * Generates points of the Sobol sequence in the unit hypercube.
+     *
+     * Points are enumerated in Gray code order [1], so that stepping to the
+     * next point takes a single XOR per coordinate. Jumping to an arbitrary
+     * index takes at most 32 XORs per coordinate, which allows partitioning
+     * the sequence among parallel workers.
+     *
+     * Coordinates are 32-bit fixed-point numbers, so the sequence has 2^32
+     * points. The first point is the origin unless scrambled. Generating
+     * points past the end of the sequence is undefined.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::sobol_engine sobol {3};
+     * sobol.scramble(engine, ext::sobol_scrambling::owen);
+     *
+     * std::vector<double> points(1024 * sobol.dimension());
+     * sobol.fill(points);
+     * ```
+     *
+     * [1]: I. A. Antonov and V. M. Saleev, "An economic method of computing
+     *      LP_tau-sequences", USSR Computational Mathematics and Mathematical
+     *      Physics 19 (1979) 252-256.
+     */
+    struct sobol_engine
+    {
+        using result_type = std::uint32_t;
+        using size_type = std::size_t;
+
+        /*
+         * The maximum number of dimensions supported by the built-in table.
+         */
+        static constexpr size_type max_dimension = sobol_tables<>::size + 1;
+
+      private:
+        static constexpr unsigned bits = 32;
+
+      public:
+        //----------------------------------------------------------------------
+        // Construction
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs an engine generating points of specified dimension,
+         * starting at index zero without scrambling.
+         *
+         * Behaviour is undefined if the dimension is zero or greater than
+         * `max_dimension`.
+         */
+        explicit
+        sobol_engine(size_type dimension)
+            : dimension_ {dimension}
+            , directions_(dimension * bits)
+            , state_(dimension)
+            , scramble_(dimension)
+        {
+            assert(dimension > 0);
+            assert(dimension <= max_dimension);
+
+            for (size_type dim = 0; dim < dimension; ++dim)
+                init_directions(dim);
+        }
+
+        //----------------------------------------------------------------------
+        // Characteristics
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the number of coordinates of a point.
+         */
+        size_type dimension() const noexcept
+        {
+            return dimension_;
+        }
+
+        /**
+         * Returns the index of the point to be generated next.
+         */
+        std::uint64_t index() const noexcept
+        {
+            return index_;
+        }
+
+        /**
+         * Returns the scrambling method in effect.
+         */
+        ext::sobol_scrambling scrambling() const noexcept
+        {
+            return scrambling_;
+        }
+
+        //----------------------------------------------------------------------
+        // Scrambling
+        //----------------------------------------------------------------------
+
+        /**
+         * Randomizes the sequence using seeds drawn from a random number
+         * engine. This does not change the current index.
+         */
+        template<typename URNG>
+        void scramble(URNG& engine, ext::sobol_scrambling method)
+        {
+            std::uniform_int_distribution<result_type> word;
+
+            scrambling_ = method;
+            for (auto& seed : scramble_)
+                seed = (method == ext::sobol_scrambling::none ? 0 : word(engine));
+        }
+
+        //----------------------------------------------------------------------
+        // Positioning
+        //----------------------------------------------------------------------
+
+        /**
+         * Moves to the point of specified index.
+         *
+         * Behaviour is undefined if the index is not less than 2^32.
+         */
+        void seek(std::uint64_t index)
+        {
+            assert(index < (std::uint64_t(1) << bits));
+
+            index_ = index;
+
+            auto gray = index ^ (index >> 1);
+            for (auto& x : state_)
+                x = 0;
+
+            for (unsigned bit = 0; gray != 0; ++bit, gray >>= 1)
+            {
+                if (gray & 1u)
+                {
+                    result_type const* const v = &directions_[bit * dimension_];
+                    for (size_type dim = 0; dim < dimension_; ++dim)
+                        state_[dim] ^= v[dim];
+                }
+            }
+        }
+
+        /**
+         * Skips z points.
+         *
+         * Behaviour is undefined if this moves past the last point.
+         */
+        void discard(unsigned long long z)
+        {
+            seek(index_ + z);
+        }
+
+        //----------------------------------------------------------------------
+        // Generation
+        //----------------------------------------------------------------------
+
+        /**
+         * Generates points as 32-bit fixed-point numbers.
+         *
+         * The view is treated as a k-by-d matrix in row-major order and each
+         * row receives a point. The coordinate x in [0, 1) is represented as
+         * the integer x * 2^32.
+         *
+         * Behaviour is undefined if the size of `points` is not a multiple
+         * of `dimension()`.
+         */
+        void fill(ext::array_view<result_type> points)
+        {
+            generate(points, [](result_type x) { return x; });
+        }
+
+        /**
+         * Generates points as real numbers in [0, 1).
+         *
+         * The view is treated as a k-by-d matrix in row-major order and each
+         * row receives a point.
+         *
+         * Behaviour is undefined if the size of `points` is not a multiple
+         * of `dimension()`.
+         */
+        void fill(ext::array_view<double> points)
+        {
+            generate(points, [](result_type x) {
+                return double(x) * (1.0 / 4294967296.0);
+            });
+        }
+
+        //----------------------------------------------------------------------
+        // Comparison operators
+        //----------------------------------------------------------------------
+
+        friend
+        bool operator==(sobol_engine const& x, sobol_engine const& y)
+        {
+            return x.dimension_ == y.dimension_ &&
+                   x.index_ == y.index_ &&
+                   x.scrambling_ == y.scrambling_ &&
+                   x.scramble_ == y.scramble_;
+        }
+
+        friend
+        bool operator!=(sobol_engine const& x, sobol_engine const& y)
+        {
+            return !(x == y);
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        /*
+         * Computes the direction numbers of a dimension. Direction numbers are
+         * stored bit-major so that a Gray code step touches a contiguous row.
+         */
+        void init_directions(size_type dim)
+        {
+            if (dim == 0)
+            {
+                // The van der Corput sequence.
+                for (unsigned k = 0; k < bits; ++k)
+                    directions_[k * dimension_] = result_type(1) << (bits - 1 - k);
+                return;
+            }
+
+            auto const& entry = sobol_tables<>::entries[dim - 1];
+            unsigned const s = entry.degree;
+            result_type v[bits];
+
+            for (unsigned k = 0; k < s; ++k)
+                v[k] = result_type(entry.initial[k]) << (bits - 1 - k);
+
+            for (unsigned k = s; k < bits; ++k)
+            {
+                v[k] = v[k - s] ^ (v[k - s] >> s);
+                for (unsigned j = 1; j < s; ++j)
+                {
+                    if ((entry.polynomial >> (s - 1 - j)) & 1u)
+                        v[k] ^= v[k - j];
+                }
+            }
+
+            for (unsigned k = 0; k < bits; ++k)
+                directions_[k * dimension_ + dim] = v[k];
+        }
+
+        result_type scrambled(result_type x, size_type dim) const noexcept
+        {
+            switch (scrambling_)
+            {
+              case ext::sobol_scrambling::none:
+                return x;
+
+              case ext::sobol_scrambling::digital_shift:
+                return x ^ scramble_[dim];
+
+              case ext::sobol_scrambling::owen:
+                return owen_scramble(x, scramble_[dim]);
+            }
+            return x;
+        }
+
+        /*
+         * Nested uniform scramble: a Laine-Karras style hash permutes the
+         * bit-reversed value so that each bit is flipped depending only on
+         * the more significant bits.
+         */
+        static
+        result_type owen_scramble(result_type x, result_type seed) noexcept
+        {
+            x = ext::reverse_bits(x);
+            x += seed;
+            x ^= x * 0x6c50b47cu;
+            x ^= x * 0xb82f1e52u;
+            x ^= x * 0xc7afe638u;
+            x ^= x * 0x8d22f6e6u;
+            return ext::reverse_bits(x);
+        }
+
+        template<typename T, typename Convert>
+        void generate(ext::array_view<T> points, Convert convert)
+        {
+            assert(points.size() % dimension_ == 0);
+
+            T* out = points.data();
+            size_type const count = points.size() / dimension_;
+
+            for (size_type i = 0; i < count; ++i)
+            {
+                assert(index_ < (std::uint64_t(1) << bits) && "sequence exhausted");
+
+                if (scrambling_ == ext::sobol_scrambling::none)
+                {
+                    for (size_type dim = 0; dim < dimension_; ++dim)
+                        out[dim] = convert(state_[dim]);
+                }
+                else
+                {
+                    for (size_type dim = 0; dim < dimension_; ++dim)
+                        out[dim] = convert(scrambled(state_[dim], dim));
+                }
+                out += dimension_;
+
+                // Gray code step: the bit to flip is the lowest set bit of
+                // the new index.
+                ++index_;
+                if ((index_ >> bits) == 0)
+                {
+                    unsigned const bit = ext::count_trailing_zeros(index_);
+                    result_type const* const v = &directions_[bit * dimension_];
+                    for (size_type dim = 0; dim < dimension_; ++dim)
+                        state_[dim] ^= v[dim];
+                }
+            }
+        }
+
+        size_type dimension_;
+        std::uint64_t index_ = 0;
+        std::vector<result_type> directions_;
+        std::vector<result_type> state_;
+        std::vector<result_type> scramble_;
+        ext::sobol_scrambling scrambling_ = ext::sobol_scrambling::none;
+    };
+}
+
+template<typename D>
+typename ext::sobol_tables<D>::entry const ext::sobol_tables<D>::entries[] =
+{
+    {1,  0, {1}},
+    {2,  1, {1, 3}},
+    {3,  1, {1, 3, 1}},
+    {3,  2, {1, 1, 1}},
+    {4,  1, {1, 1, 3, 3}},
+    {4,  4, {1, 3, 5, 13}},
+    {5,  2, {1, 1, 5, 5, 17}},
+    {5,  4, {1, 1, 5, 5, 5}},
+    {5,  7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6,  1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+    {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}},
+    {6, 25, {1, 1, 5, 5, 19, 61}},
+    {7,  1, {1, 3, 7, 11, 23, 15, 103}},
+    {7,  4, {1, 3, 7, 13, 13, 15, 69}},
+    {7,  7, {1, 1, 3, 13, 7, 35, 63}},
+    {7,  8, {1, 3, 5, 9, 1, 25, 53}},
+    {7, 14, {1, 3, 1, 13, 9, 35, 107}},
+    {7, 19, {1, 3, 1, 5, 27, 61, 31}},
+    {7, 21, {1, 1, 5, 11, 19, 41, 61}},
+    {7, 28, {1, 3, 5, 3, 3, 13, 69}},
+    {7, 31, {1, 1, 7, 13, 1, 19, 1}},
+    {7, 32, {1, 3, 7, 5, 13, 19, 59}},
+    {7, 37, {1, 1, 3, 9, 25, 29, 41}},
+    {7, 41, {1, 3, 5, 13, 23, 1, 55}},
+    {7, 42, {1, 3, 7, 3, 13, 59, 17}},
+    {7, 50, {1, 3, 1, 3, 5, 53, 69}},
+    {7, 55, {1, 1, 5, 5, 23, 33, 13}},
+    {7, 56, {1, 1, 7, 7, 1, 61, 123}},
+    {7, 59, {1, 1, 7, 9, 13, 61, 49}},
+    {7, 62, {1, 3, 3, 5, 3, 55, 33}},
+    {8, 14, {1, 3, 1, 15, 31, 13, 49, 245}},
+    {8, 21, {1, 3, 5, 15, 31, 59, 63, 97}},
+    {8, 22, {1, 3, 1, 11, 11, 11, 77, 249}}
+};
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * Per-thread random number engines.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_THREAD_ENGINE_HPP
+#define EXT_THREAD_ENGINE_HPP
+
+#include <atomic>
+
+#include <cstdint>
+
+#include "seed_seq_fe.hpp"
+#include "small_fast_counting_engine_v4.hpp"
+
+namespace ext
+{
+    namespace detail
+    {
+        /*
+         * Process-wide state shared by the engines of all threads. Wrapped in
+         * a class template so that the header can define the variables.
+         */
+        template<typename Dummy = void>
+        struct thread_engine_registry
+        {
+            static std::atomic<std::uint64_t> process_seed;
+            static std::atomic<std::uint64_t> next_stream;
+        };
+
+        template<typename D>
+        std::atomic<std::uint64_t> thread_engine_registry<D>::process_seed {0};
+
+        template<typename D>
+        std::atomic<std::uint64_t> thread_engine_registry<D>::next_stream {0};
+
+        /*
+         * Seeds with the process seed, the stream id and a domain word that
+         * keeps the streams apart from those of `ext::make_chunk_engine`.
+         */
+        template<typename Engine>
+        Engine make_thread_engine(std::uint64_t& stream)
+        {
+            using registry = thread_engine_registry<>;
+            constexpr std::uint32_t domain = 0x74687264; // "thrd"
+
+            auto const seed =
+                registry::process_seed.load(std::memory_order_relaxed);
+            stream =
+                registry::next_stream.fetch_add(1, std::memory_order_relaxed);
+
+            ext::seed_seq_fe<4> seed_seq {
+                std::uint32_t(seed),
+                std::uint32_t(seed >> 32),
+                std::uint32_t(stream),
+                std::uint32_t(stream >> 32),
+                domain
+            };
+            return Engine {seed_seq};
+        }
+
+        template<typename Engine>
+        struct thread_engine_slot
+        {
+            std::uint64_t stream = 0;
+            Engine engine = make_thread_engine<Engine>(stream);
+        };
+
+        template<typename Engine>
+        thread_engine_slot<Engine>& thread_engine_slot_instance()
+        {
+            thread_local thread_engine_slot<Engine> slot;
+            return slot;
+        }
+    }
+
+    /**
+     * Sets the process seed of thread engines and restarts the numbering of
+     * streams from zero.
+     *
+     * Engines already created by `ext::thread_engine` are not affected, so
+     * call this before any thread uses its engine. The default process seed
+     * is zero.
+     */
+    inline
+    void seed_thread_engines(std::uint64_t seed) noexcept
+    {
+        using registry = detail::thread_engine_registry<>;
+        registry::process_seed.store(seed, std::memory_order_relaxed);
+        registry::next_stream.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the engine of the calling thread.
+     *
+     * The engine is created on the first call in each thread and seeded with
+     * the process seed and a stream id taken from an atomic counter, which
+     * is shared by all engine types. Thread engines are thus reproducible as
+     * long as threads make their first calls in the same order. Subsequent
+     * calls just return the thread-local engine without synchronization.
+     * Streams differ from the chunk streams of `ext::parallel_generate` for
+     * the same seed.
+     *
+     * === Example ===
+     *
+     * ```
+     * ext::seed_thread_engines(run_seed);
+     *
+     * // In worker threads
+     * std::normal_distribution<double> normal;
+     * auto const noise = normal(ext::thread_engine());
+     * ```
+     */
+    template<typename Engine = ext::sfc64>
+    Engine& thread_engine()
+    {
+        return detail::thread_engine_slot_instance<Engine>().engine;
+    }
+
+    /**
+     * Returns the stream id of the engine of the calling thread, creating
+     * the engine if necessary.
+     */
+    template<typename Engine = ext::sfc64>
+    std::uint64_t thread_engine_stream()
+    {
+        return detail::thread_engine_slot_instance<Engine>().stream;
+    }
+}
+
+#endif
@@ -0,0 +1,308 @@
+/*
+ * Truncated normal distribution with fast tail handling.
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef EXT_TRUNCATED_NORMAL_DISTRIBUTION_HPP
+#define EXT_TRUNCATED_NORMAL_DISTRIBUTION_HPP
+
+#include <limits>
+#include <random>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "array_view.hpp"
+#include "ziggurat_normal_distribution.hpp"
+
+namespace ext
+{
+    /**
+     * Produces real values on the normal distribution restricted to a closed
+     * interval.
+     *
+     * One of three rejection samplers is chosen on construction by comparing
+     * their acceptance rates [1] weighted with the relative cost of a single
+     * proposal:
+     *
+     * - Normal proposals from the ziggurat algorithm, for intervals holding
+     *   a large part of the probability mass.
+     * - Uniform proposals, for short intervals.
+     * - Shifted exponential proposals with Robert's optimal rate, for
+     *   intervals in the tail. This is the same tail sampler as the one the
+     *   ziggurat algorithm uses beyond its base layer, only started at the
+     *   bound of the interval instead of the fixed tail start.
+     *
+     * Intervals lying on the negative side are sampled by reflection. Bounds
+     * can be infinite.
+     *
+     * [1]: C. P. Robert, "Simulation of truncated normal variables",
+     *      Statistics and Computing 5 (1995) 121-125.
+     */
+    template<typename T = double>
+    struct truncated_normal_distribution
+    {
+        using result_type = T;
+
+      private:
+        static constexpr std::size_t canonical_bits =
+            std::numeric_limits<double>::digits;
+
+      public:
+        //----------------------------------------------------------------------
+        // Construction
+        //----------------------------------------------------------------------
+
+        /**
+         * Constructs the normal distribution with specified mean and standard
+         * deviation truncated to the interval [lower, upper].
+         *
+         * Behaviour is undefined if `stddev` is not positive or the interval
+         * is empty.
+         */
+        truncated_normal_distribution(result_type mean,
+                                      result_type stddev,
+                                      result_type lower,
+                                      result_type upper)
+            : mean_ {mean}
+            , stddev_ {stddev}
+            , lower_ {lower}
+            , upper_ {upper}
+        {
+            assert(stddev > 0);
+            assert(lower < upper);
+
+            alpha_ = double(lower - mean) / double(stddev);
+            beta_ = double(upper - mean) / double(stddev);
+
+            // Reflect the interval to the positive side or make it straddle
+            // the origin.
+            if (beta_ <= 0)
+            {
+                double const tmp = alpha_;
+                alpha_ = -beta_;
+                beta_ = -tmp;
+                sign_ = -1;
+            }
+
+            choose_method();
+        }
+
+        //----------------------------------------------------------------------
+        // Characteristics
+        //----------------------------------------------------------------------
+
+        /**
+         * Returns the mean of the underlying normal distribution.
+         */
+        result_type mean() const noexcept
+        {
+            return mean_;
+        }
+
+        /**
+         * Returns the standard deviation of the underlying normal
+         * distribution.
+         */
+        result_type stddev() const noexcept
+        {
+            return stddev_;
+        }
+
+        /**
+         * Returns the lower bound of the interval.
+         */
+        result_type lower() const noexcept
+        {
+            return lower_;
+        }
+
+        /**
+         * Returns the upper bound of the interval.
+         */
+        result_type upper() const noexcept
+        {
+            return upper_;
+        }
+
+        result_type min() const noexcept
+        {
+            return lower_;
+        }
+
+        result_type max() const noexcept
+        {
+            return upper_;
+        }
+
+        /**
+         * Does nothing. The distribution has no internal state.
+         */
+        void reset() noexcept
+        {
+        }
+
+        //----------------------------------------------------------------------
+        // Generation
+        //----------------------------------------------------------------------
+
+        /**
+         * Generates a random number.
+         */
+        template<typename URNG>
+        result_type operator()(URNG& engine)
+        {
+            double const z = sign_ * sample_standard(engine);
+            auto const x = static_cast<result_type>(mean_ + stddev_ * z);
+
+            // Guard against rounding at the bounds.
+            return x < lower_ ? lower_ :
+                   x > upper_ ? upper_ : x;
+        }
+
+        /**
+         * Fills the view with random numbers.
+         */
+        template<typename URNG>
+        void fill(URNG& engine, ext::array_view<result_type> output)
+        {
+            for (auto& value : output)
+                value = (*this)(engine);
+        }
+
+        //----------------------------------------------------------------------
+        // Comparison operators
+        //----------------------------------------------------------------------
+
+        friend
+        bool operator==(truncated_normal_distribution const& x,
+                        truncated_normal_distribution const& y) noexcept
+        {
+            return x.mean_ == y.mean_ && x.stddev_ == y.stddev_ &&
+                   x.lower_ == y.lower_ && x.upper_ == y.upper_;
+        }
+
+        friend
+        bool operator!=(truncated_normal_distribution const& x,
+                        truncated_normal_distribution const& y) noexcept
+        {
+            return !(x == y);
+        }
+
+        //----------------------------------------------------------------------
+      private:
+        enum class method
+        {
+            normal,
+            uniform,
+            exponential
+        };
+
+        /*
+         * Chooses the sampler with the smallest expected cost per sample.
+         *
+         * The acceptance rate of each sampler is (Phi(beta) - Phi(alpha))
+         * times the factor computed below, so the common term is dropped.
+         * Costs are rough relative times of a single proposal. They are
+         * compared in log space since the factors overflow in far tails.
+         */
+        void choose_method()
+        {
+            double const log_sqrt_2pi = 0.91893853320467274;
+            double const normal_cost = 1;
+            double const uniform_cost = 2;
+            double const exponential_cost = 3;
+
+            double best = std::log(normal_cost);
+            method_ = method::normal;
+
+            if (beta_ - alpha_ < std::numeric_limits<double>::infinity())
+            {
+                uniform_peak_ = alpha_ > 0 ? alpha_ : 0;
+                double const log_factor = log_sqrt_2pi
+                    + uniform_peak_ * uniform_peak_ / 2
+                    - std::log(beta_ - alpha_);
+                double const log_cost = std::log(uniform_cost) - log_factor;
+                if (log_cost < best)
+                {
+                    best = log_cost;
+                    method_ = method::uniform;
+                }
+            }
+
+            if (alpha_ > 0)
+            {
+                rate_ = (alpha_ + std::sqrt(alpha_ * alpha_ + 4)) / 2;
+                double const log_factor = log_sqrt_2pi + std::log(rate_)
+                    + alpha_ * rate_ - rate_ * rate_ / 2;
+                double const log_cost = std::log(exponential_cost) - log_factor;
+                if (log_cost < best)
+                {
+                    best = log_cost;
+                    method_ = method::exponential;
+                }
+            }
+        }
+
+        /*
+         * Samples from the standard normal distribution truncated to the
+         * reflected interval [alpha, beta].
+         */
+        template<typename URNG>
+        double sample_standard(URNG& engine)
+        {
+            switch (method_)
+            {
+              case method::normal:
+                for (;;)
+                {
+                    double const z = normal_(engine);
+                    if (z >= alpha_ && z <= beta_)
+                        return z;
+                }
+
+              case method::uniform:
+                for (;;)
+                {
+                    double const u = std::generate_canonical<double, canonical_bits>(engine);
+                    double const v = std::generate_canonical<double, canonical_bits>(engine);
+                    double const z = alpha_ + (beta_ - alpha_) * u;
+                    double const log_ratio = (uniform_peak_ * uniform_peak_ - z * z) / 2;
+                    if (v <= std::exp(log_ratio))
+                        return z;
+                }
+
+              case method::exponential:
+                for (;;)
+                {
+                    double const z = detail::sample_normal_tail<canonical_bits>(
+                            engine, alpha_, rate_);
+                    if (z <= beta_)
+                        return z;
+                }
+            }
+
+            assert(false);
+            return alpha_;
+        }
+
+        result_type mean_;
+        result_type stddev_;
+        result_type lower_;
+        result_type upper_;
+
+        // Standardized interval, reflected if necessary.
+        double alpha_;
+        double beta_;
+        double sign_ = 1;
+
+        method method_ = method::normal;
+        double uniform_peak_ = 0;
+        double rate_ = 0;
+        ext::ziggurat_normal_distribution<double> normal_;
+    };
+}
+
+#endif
@@ -57,6 +57,26 @@ namespace ext
     std::size_t const type_directory::index<T>::value
         = type_directory::counter()++;
 
+    /**
+     * Identifier of a static type that does not rely on RTTI.
+     *
+     * The identifier is the address of `ext::type_directory::index<T>::value`,
+     * which is unique for each type, so comparing identifiers is a single
+     * pointer comparison. Dereferencing an identifier gives the hash code of
+     * the type.
+     */
+    using type_id = std::size_t const*;
+
+    /**
+     * Returns the identifier of the static type `T`.
+     */
+    template<typename T>
+    constexpr
+    ext::type_id type_id_of() noexcept
+    {
+        return &ext::type_directory::index<T>::value;
+    }
+
     /**
      * Collection of `T` values associated to static types.
      *
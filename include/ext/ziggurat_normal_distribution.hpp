@@ -14,6 +14,8 @@
 #include <cmath>
 #include <cstddef>
 
+#include "array_view.hpp"
+
 namespace ext
 {
     template<typename Tag, typename Dummy = void>
@@ -48,6 +50,29 @@ namespace ext
             auto const value = engine() - URNG::min();
             return std::pair<unsigned, double>(value & mask, double(value >> bits) * norm);
         }
+
+        /*
+         * Samples from the tail x > start of the standard normal distribution
+         * using shifted exponential proposals with given rate. The rate equal
+         * to start gives Marsaglia's method used by the ziggurat algorithm,
+         * and (start + sqrt(start^2 + 4)) / 2 gives Robert's optimal rate.
+         */
+        template<std::size_t canonical_bits, typename URNG>
+        double sample_normal_tail(URNG& engine, double start, double rate)
+        {
+            double x, y, d;
+            do
+            {
+                auto const s = std::generate_canonical<double, canonical_bits>(engine);
+                auto const t = std::generate_canonical<double, canonical_bits>(engine);
+                x = -std::log(s) / rate;
+                y = -std::log(t);
+                d = start + x - rate;
+            }
+            while (2 * y < d * d);
+
+            return start + x;
+        }
     }
 
     /**
@@ -88,6 +113,16 @@ namespace ext
             return static_cast<result_type>(sample(engine));
         }
 
+        /**
+         * Fills the view with random numbers.
+         */
+        template<typename URNG>
+        void fill(URNG& engine, ext::array_view<result_type> output)
+        {
+            for (auto& value : output)
+                value = static_cast<result_type>(sample(engine));
+        }
+
       private:
         template<typename URNG>
         double sample(URNG& engine) const
@@ -118,17 +153,8 @@ namespace ext
         template<typename URNG>
         double sample_from_tail(URNG& engine) const
         {
-            double x, y;
-            do
-            {
-                auto const s = std::generate_canonical<double, canonical_bits>(engine);
-                auto const t = std::generate_canonical<double, canonical_bits>(engine);
-                x = -std::log(s) / ziggurat::tail_start;
-                y = -std::log(t);
-            }
-            while (2 * y < x * x);
-
-            return ziggurat::tail_start + x;
+            return detail::sample_normal_tail<canonical_bits>(
+                    engine, ziggurat::tail_start, ziggurat::tail_start);
         }
     };
 
@@ -1,6 +1,13 @@
+#include <memory>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
 #include <catch.hpp>
 #include <ext/any.hpp>
+#include "counting_resource.hpp"
 
 
 TEST_CASE("ext::any - default construction")
@@ -95,6 +102,38 @@ TEST_CASE("ext::any - emplace")
     CHECK(any.value<int>() == 1234);
 }
 
+TEST_CASE("ext::any - emplace keeps content if construction throws")
+{
+    struct throwing
+    {
+        explicit throwing(int)
+        {
+            throw 1;
+        }
+    };
+
+    struct large_throwing
+    {
+        explicit large_throwing(int)
+        {
+            throw 1;
+        }
+
+        char data[64];
+    };
+
+    ext::any any {std::string(100, 'x')};
+    CHECK_THROWS(any.emplace<throwing>(1));
+    CHECK_THROWS(any.emplace<large_throwing>(1));
+    REQUIRE(any.has_value_of<std::string>());
+    CHECK(any.value<std::string>() == std::string(100, 'x'));
+
+    ext::unique_any unique {std::make_unique<int>(5)};
+    CHECK_THROWS(unique.emplace<throwing>(1));
+    REQUIRE(unique.has_value_of<std::unique_ptr<int>>());
+    CHECK(*unique.value<std::unique_ptr<int>>() == 5);
+}
+
 TEST_CASE("ext::any - reset")
 {
     ext::any any {123};
@@ -129,3 +168,314 @@ TEST_CASE("ext::any - const correctness")
     CHECK(any.value<int>() == 42);
     CHECK((std::is_same<decltype(any.value<int>()), int const&>::value));
 }
+
+namespace
+{
+    bool is_in_place(void const* value, ext::any const& any)
+    {
+        auto const address = reinterpret_cast<std::uintptr_t>(value);
+        auto const self = reinterpret_cast<std::uintptr_t>(&any);
+        return address >= self && address < self + sizeof any;
+    }
+}
+
+TEST_CASE("ext::any - small buffer")
+{
+    SECTION("small value is stored in place")
+    {
+        ext::any any {42};
+        CHECK(is_in_place(&any.value<int>(), any));
+    }
+
+    SECTION("large value is stored on heap")
+    {
+        struct large
+        {
+            double values[8];
+        };
+        ext::any any {large {{1, 2, 3, 4, 5, 6, 7, 8}}};
+        auto const address = &any.value<large>();
+        CHECK_FALSE(is_in_place(address, any));
+
+        ext::any moved {std::move(any)};
+        CHECK(&moved.value<large>() == address);
+        CHECK(moved.value<large>().values[7] == 8);
+    }
+
+    SECTION("moving value keeps content")
+    {
+        ext::any any_1 {std::string(100, 'x')};
+        ext::any any_2 {std::move(any_1)};
+        CHECK_FALSE(any_1.has_value());
+        CHECK(any_2.value<std::string>() == std::string(100, 'x'));
+    }
+
+    SECTION("swapping local and heap values")
+    {
+        struct large
+        {
+            int values[16];
+        };
+        ext::any any_1 {123};
+        ext::any any_2 {large {{4, 5, 6}}};
+        any_1.swap(any_2);
+        CHECK(any_1.has_value_of<large>());
+        CHECK(any_1.value<large>().values[2] == 6);
+        CHECK(any_2.has_value_of<int>());
+        CHECK(any_2.value<int>() == 123);
+    }
+
+    SECTION("copying does not share content")
+    {
+        ext::any any_1 {std::string("abc")};
+        ext::any any_2 {any_1};
+        any_2.value<std::string>() += "def";
+        CHECK(any_1.value<std::string>() == "abc");
+        CHECK(any_2.value<std::string>() == "abcdef");
+    }
+}
+
+TEST_CASE("ext::any - type identifier")
+{
+    ext::any any;
+    CHECK(any.type() == nullptr);
+
+    any = 42;
+    CHECK(any.type() == ext::type_id_of<int>());
+    CHECK_FALSE(any.has_value_of<long>());
+    CHECK_FALSE(any.has_value_of<int const>());
+
+    ext::any copy {any};
+    CHECK(copy.type() == ext::type_id_of<int>());
+
+    ext::any moved {std::move(any)};
+    CHECK(moved.type() == ext::type_id_of<int>());
+    CHECK(any.type() == nullptr);
+
+    moved.reset();
+    CHECK_FALSE(moved.has_value_of<int>());
+}
+
+TEST_CASE("ext::any - size")
+{
+    CHECK(sizeof(ext::any) == 4 * sizeof(void*));
+}
+
+TEST_CASE("ext::unique_any - move-only content")
+{
+    ext::unique_any any {std::make_unique<int>(42)};
+    CHECK(any.has_value());
+    CHECK(any.has_value_of<std::unique_ptr<int>>());
+    CHECK(*any.value<std::unique_ptr<int>>() == 42);
+
+    ext::unique_any moved {std::move(any)};
+    CHECK_FALSE(any.has_value());
+    CHECK(*moved.value<std::unique_ptr<int>>() == 42);
+
+    any = std::move(moved);
+    CHECK(any.has_value_of<std::unique_ptr<int>>());
+    CHECK_FALSE(moved.has_value());
+
+    CHECK_FALSE(std::is_copy_constructible<ext::unique_any>::value);
+    CHECK(sizeof(ext::unique_any) == sizeof(ext::any));
+}
+
+TEST_CASE("ext::unique_any - emplace and reset")
+{
+    struct large
+    {
+        std::unique_ptr<int> values[8];
+    };
+
+    ext::unique_any any;
+    any.emplace<large>();
+    CHECK(any.has_value_of<large>());
+    any.value<large>().values[7] = std::make_unique<int>(1);
+    CHECK(*any.value<large>().values[7] == 1);
+
+    any.reset();
+    CHECK_FALSE(any.has_value());
+    CHECK(any.type() == nullptr);
+}
+
+TEST_CASE("ext::unique_any - swap")
+{
+    ext::unique_any any_1 {std::make_unique<int>(1)};
+    ext::unique_any any_2 {std::string(100, 'x')};
+    any_1.swap(any_2);
+    CHECK(any_1.value<std::string>() == std::string(100, 'x'));
+    CHECK(*any_2.value<std::unique_ptr<int>>() == 1);
+}
+
+TEST_CASE("ext::unique_any - conversion from any")
+{
+    SECTION("local content")
+    {
+        ext::any any {42};
+        ext::unique_any unique {std::move(any)};
+        CHECK_FALSE(any.has_value());
+        CHECK(unique.has_value_of<int>());
+        CHECK(unique.value<int>() == 42);
+    }
+
+    SECTION("heap content is not reallocated")
+    {
+        ext::any any {std::string(100, 'x')};
+        auto const address = &any.value<std::string>();
+        ext::unique_any unique {std::move(any)};
+        CHECK(&unique.value<std::string>() == address);
+    }
+
+    SECTION("empty any")
+    {
+        ext::unique_any unique {ext::any {}};
+        CHECK_FALSE(unique.has_value());
+    }
+
+    SECTION("assignment")
+    {
+        ext::unique_any unique {std::make_unique<int>(1)};
+        unique = ext::any {3.5};
+        CHECK(unique.has_value_of<double>());
+        CHECK(unique.value<double>() == 3.5);
+    }
+}
+
+TEST_CASE("ext::any - memory resource")
+{
+    test::counting_resource resource;
+    std::string const text(100, 'x');
+
+    SECTION("heap content is allocated from resource")
+    {
+        {
+            ext::any any {std::allocator_arg, &resource, text};
+            CHECK(resource.allocations == 1);
+            CHECK(any.value<std::string>() == text);
+        }
+        CHECK(resource.deallocations == 1);
+    }
+
+    SECTION("local content does not allocate")
+    {
+        ext::any any {std::allocator_arg, &resource, 42};
+        CHECK(resource.allocations == 0);
+        CHECK(any.value<int>() == 42);
+    }
+
+    SECTION("copy propagates resource")
+    {
+        ext::any any {std::allocator_arg, &resource, text};
+        ext::any copy {any};
+        CHECK(resource.allocations == 2);
+
+        ext::any assigned;
+        assigned = copy;
+        CHECK(resource.allocations == 3);
+        CHECK(assigned.value<std::string>() == text);
+    }
+
+    SECTION("allocator-extended copy uses given resource")
+    {
+        test::counting_resource other;
+        ext::any any {std::allocator_arg, &resource, text};
+        ext::any copy {std::allocator_arg, &other, any};
+        CHECK(resource.allocations == 1);
+        CHECK(other.allocations == 1);
+        CHECK(copy.value<std::string>() == text);
+
+        ext::any plain {text};
+        ext::any plain_copy {std::allocator_arg, &other, plain};
+        CHECK(other.allocations == 2);
+    }
+
+    SECTION("move keeps allocation")
+    {
+        ext::any any {std::allocator_arg, &resource, text};
+        ext::unique_any unique {std::move(any)};
+        ext::unique_any moved {std::move(unique)};
+        CHECK(resource.allocations == 1);
+        moved.reset();
+        CHECK(resource.deallocations == 1);
+    }
+
+    SECTION("monotonic arena")
+    {
+        ext::monotonic_buffer_resource arena {4096, &resource};
+        std::vector<ext::any> values;
+        for (int i = 0; i < 10; ++i)
+            values.emplace_back(std::allocator_arg, &arena, text);
+        CHECK(resource.allocations == 1);
+        values.clear();
+        CHECK(resource.deallocations == 0);
+    }
+}
+
+TEST_CASE("ext::any - over-aligned content")
+{
+    struct alignas(64) aligned
+    {
+        int value;
+    };
+
+    ext::any any {aligned {42}};
+    auto const address = reinterpret_cast<std::uintptr_t>(&any.value<aligned>());
+    CHECK(address % 64 == 0);
+    CHECK(any.value<aligned>().value == 42);
+
+    ext::any const copy {any};
+    CHECK(reinterpret_cast<std::uintptr_t>(&copy.value<aligned>()) % 64 == 0);
+}
+
+TEST_CASE("ext::visit")
+{
+    auto const describe = [](auto const& value) {
+        return std::string(sizeof value == sizeof(int) ? "int" : "other");
+    };
+
+    SECTION("calls function with content of listed type")
+    {
+        ext::any any {42};
+        auto const result = ext::visit<double, int>(any, [](auto& value) {
+            value += 1;
+            return static_cast<double>(value);
+        });
+        CHECK(result == 43);
+        CHECK(any.value<int>() == 43);
+    }
+
+    SECTION("dispatches on each listed type")
+    {
+        std::vector<ext::any> values {
+            ext::any {1}, ext::any {2.5}, ext::any {std::string("abc")}
+        };
+        struct kind
+        {
+            int operator()(int) const { return 1; }
+            int operator()(double) const { return 2; }
+            int operator()(std::string const&) const { return 3; }
+        };
+        std::vector<int> kinds;
+        for (auto const& value : values)
+            kinds.push_back(ext::visit<std::string, double, int>(value, kind {}));
+        CHECK(kinds == (std::vector<int> {1, 2, 3}));
+    }
+
+    SECTION("calls fallback for unlisted type")
+    {
+        ext::any any {'c'};
+        auto const result = ext::visit<int, long>(
+            any, describe, [](ext::any& other) {
+                return std::string(1, other.value<char>());
+            });
+        CHECK(result == "c");
+    }
+
+    SECTION("calls fallback for empty object")
+    {
+        ext::any any;
+        bool called = false;
+        ext::visit<int>(any, [](int) {}, [&](ext::any const&) { called = true; });
+        CHECK(called);
+    }
+}
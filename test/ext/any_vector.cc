@@ -0,0 +1,270 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <catch.hpp>
+#include <ext/any_vector.hpp>
+
+
+namespace
+{
+    struct counted
+    {
+        explicit counted(int* live) noexcept
+            : live_ {live}
+        {
+            ++*live_;
+        }
+
+        counted(counted const& other) noexcept
+            : live_ {other.live_}
+        {
+            ++*live_;
+        }
+
+        counted(counted&& other) noexcept
+            : live_ {other.live_}
+        {
+            ++*live_;
+        }
+
+        ~counted()
+        {
+            --*live_;
+        }
+
+        int* live_;
+    };
+
+    template<typename T>
+    bool is_aligned(T const& object)
+    {
+        return reinterpret_cast<std::uintptr_t>(&object) % alignof(T) == 0;
+    }
+}
+
+TEST_CASE("ext::any_vector - default construction")
+{
+    ext::any_vector vector;
+    CHECK(vector.empty());
+    CHECK(vector.size() == 0);
+    CHECK(vector.bytes() == 0);
+}
+
+TEST_CASE("ext::any_vector - push_back stores values of different types")
+{
+    ext::any_vector vector;
+    vector.push_back(42);
+    vector.push_back(std::string("hello"));
+    vector.push_back(3.5);
+
+    REQUIRE(vector.size() == 3);
+    CHECK(vector.has_value_of<int>(0));
+    CHECK(vector.has_value_of<std::string>(1));
+    CHECK(vector.has_value_of<double>(2));
+    CHECK_FALSE(vector.has_value_of<double>(0));
+    CHECK(vector.type(0) == ext::type_id_of<int>());
+
+    CHECK(vector.value<int>(0) == 42);
+    CHECK(vector.value<std::string>(1) == "hello");
+    CHECK(vector.value<double>(2) == 3.5);
+}
+
+TEST_CASE("ext::any_vector - emplace_back constructs in place")
+{
+    ext::any_vector vector;
+    auto& str = vector.emplace_back<std::string>(3, 'x');
+    CHECK(str == "xxx");
+    CHECK(&str == &vector.value<std::string>(0));
+}
+
+TEST_CASE("ext::any_vector - values are aligned")
+{
+    ext::any_vector vector;
+    vector.push_back('a');
+    auto& d = vector.push_back(1.0);
+    CHECK(is_aligned(d));
+    vector.push_back(short(1));
+    auto& p = vector.push_back(static_cast<void*>(nullptr));
+    CHECK(is_aligned(p));
+
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        vector.push_back('b');
+        vector.push_back(std::uint64_t(i));
+    }
+    for (std::size_t i = 0; i < vector.size(); ++i)
+    {
+        if (vector.has_value_of<std::uint64_t>(i))
+            CHECK(is_aligned(vector.value<std::uint64_t>(i)));
+    }
+}
+
+TEST_CASE("ext::any_vector - values survive growth")
+{
+    ext::any_vector vector;
+    for (int i = 0; i < 200; ++i)
+    {
+        vector.push_back(i);
+        vector.push_back(std::to_string(i));
+    }
+
+    REQUIRE(vector.size() == 400);
+    for (int i = 0; i < 200; ++i)
+    {
+        auto const index = static_cast<std::size_t>(2 * i);
+        CHECK(vector.value<int>(index) == i);
+        CHECK(vector.value<std::string>(index + 1) == std::to_string(i));
+    }
+}
+
+TEST_CASE("ext::any_vector - push_back of a stored value")
+{
+    ext::any_vector vector;
+    vector.push_back(std::string(100, 'x'));
+
+    // Each push grows the arena while the argument refers into it.
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        vector.push_back(vector.value<std::string>(i));
+        CHECK(vector.value<std::string>(i + 1) == std::string(100, 'x'));
+    }
+    CHECK(vector.value<std::string>(0) == std::string(100, 'x'));
+}
+
+TEST_CASE("ext::any_vector - for_each visits values of one type")
+{
+    ext::any_vector vector;
+    vector.push_back(1);
+    vector.push_back(std::string("a"));
+    vector.push_back(2);
+    vector.push_back(2.5);
+    vector.push_back(3);
+
+    std::vector<int> ints;
+    vector.for_each<int>([&](int& value) {
+        ints.push_back(value);
+        value *= 10;
+    });
+    CHECK(ints == (std::vector<int> {1, 2, 3}));
+    CHECK(vector.value<int>(2) == 20);
+
+    ext::any_vector const& const_vector = vector;
+    std::vector<std::string> strings;
+    const_vector.for_each<std::string>([&](std::string const& value) {
+        strings.push_back(value);
+    });
+    CHECK(strings == (std::vector<std::string> {"a"}));
+}
+
+TEST_CASE("ext::any_vector - clear destroys values")
+{
+    int live = 0;
+    ext::any_vector vector;
+    vector.push_back(1);
+    for (int i = 0; i < 10; ++i)
+        vector.emplace_back<counted>(&live);
+    CHECK(live == 10);
+
+    vector.clear();
+    CHECK(live == 0);
+    CHECK(vector.empty());
+    CHECK(vector.bytes() == 0);
+
+    vector.emplace_back<counted>(&live);
+    CHECK(live == 1);
+}
+
+TEST_CASE("ext::any_vector - destructor destroys values")
+{
+    int live = 0;
+    {
+        ext::any_vector vector;
+        for (int i = 0; i < 50; ++i)
+            vector.emplace_back<counted>(&live);
+        CHECK(live == 50);
+    }
+    CHECK(live == 0);
+}
+
+TEST_CASE("ext::any_vector - copy construction")
+{
+    int live = 0;
+    ext::any_vector vector;
+    vector.push_back(7);
+    vector.push_back(std::string("seven"));
+    vector.emplace_back<counted>(&live);
+
+    ext::any_vector copy {vector};
+    REQUIRE(copy.size() == 3);
+    CHECK(copy.value<int>(0) == 7);
+    CHECK(copy.value<std::string>(1) == "seven");
+    CHECK(copy.has_value_of<counted>(2));
+    CHECK(live == 2);
+
+    copy.value<std::string>(1) = "eight";
+    CHECK(vector.value<std::string>(1) == "seven");
+}
+
+TEST_CASE("ext::any_vector - move construction")
+{
+    ext::any_vector vector;
+    vector.push_back(std::string("moved"));
+    auto const address = &vector.value<std::string>(0);
+
+    ext::any_vector moved {std::move(vector)};
+    CHECK(vector.empty());
+    REQUIRE(moved.size() == 1);
+    CHECK(&moved.value<std::string>(0) == address);
+}
+
+TEST_CASE("ext::any_vector - assignment")
+{
+    int live = 0;
+    ext::any_vector a;
+    a.emplace_back<counted>(&live);
+    a.push_back(1);
+
+    ext::any_vector b;
+    b.emplace_back<counted>(&live);
+    CHECK(live == 2);
+
+    b = a;
+    CHECK(live == 2);
+    CHECK(b.size() == 2);
+
+    b = std::move(a);
+    CHECK(live == 1);
+    CHECK(b.size() == 2);
+}
+
+TEST_CASE("ext::any_vector - move-only values")
+{
+    ext::any_vector vector;
+    vector.push_back(std::make_unique<int>(5));
+    for (int i = 0; i < 20; ++i)
+        vector.push_back(i);
+    CHECK(*vector.value<std::unique_ptr<int>>(0) == 5);
+}
+
+TEST_CASE("ext::any_vector - many values")
+{
+    ext::any_vector vector;
+    for (int i = 0; i < 200000; ++i)
+        vector.push_back(i);
+    REQUIRE(vector.size() == 200000);
+    CHECK(vector.value<int>(0) == 0);
+    CHECK(vector.value<int>(123456) == 123456);
+    CHECK(vector.value<int>(199999) == 199999);
+}
+
+TEST_CASE("ext::any_vector - reserve")
+{
+    ext::any_vector vector;
+    vector.reserve(2, 2 * sizeof(double));
+    auto const& first = vector.push_back(1.0);
+    vector.push_back(2.0);
+    CHECK(&first == &vector.value<double>(0));
+}
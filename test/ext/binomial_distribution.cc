@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <cmath>
+
+#include <catch.hpp>
+
+#include <ext/array_view.hpp>
+#include <ext/binomial_distribution.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+
+
+namespace
+{
+    double binomial_pmf(long n, double p, long k)
+    {
+        return std::exp(std::lgamma(double(n) + 1)
+                        - std::lgamma(double(k) + 1)
+                        - std::lgamma(double(n - k) + 1)
+                        + double(k) * std::log(p)
+                        + double(n - k) * std::log1p(-p));
+    }
+}
+
+TEST_CASE("ext::binomial_distribution - characteristics")
+{
+    ext::binomial_distribution<int> const binomial {10, 0.25};
+    CHECK(binomial.t() == 10);
+    CHECK(binomial.p() == 0.25);
+    CHECK(binomial.min() == 0);
+    CHECK(binomial.max() == 10);
+    CHECK(binomial == (ext::binomial_distribution<int> {10, 0.25}));
+    CHECK(binomial != (ext::binomial_distribution<int> {10, 0.5}));
+}
+
+TEST_CASE("ext::binomial_distribution - moment test", "[random]")
+{
+    ext::sfc64 engine;
+
+    // Covers both table inversion and BTRD, and both sides of p = 1/2.
+    std::vector<std::pair<long, double>> const params {
+        {1, 0.5}, {20, 0.1}, {100, 0.05}, {30, 0.9}, {40, 0.3},
+        {1000, 0.5}, {5000, 0.97}, {1000000, 0.2}
+    };
+
+    for (auto const& param : params)
+    {
+        auto const n = param.first;
+        auto const p = param.second;
+        ext::binomial_distribution<long> binomial {n, p};
+
+        auto const sample_count = 200000uL;
+        double sum = 0;
+        double sum_sq = 0;
+        long min = n;
+        long max = 0;
+        for (auto i = 0uL; i < sample_count; ++i)
+        {
+            auto const k = binomial(engine);
+            auto const x = double(k);
+            min = std::min(min, k);
+            max = std::max(max, k);
+            sum += x;
+            sum_sq += x * x;
+        }
+        CHECK(min >= 0);
+        CHECK(max <= n);
+        auto const sample_mean = sum / double(sample_count);
+        auto const sample_var = sum_sq / double(sample_count)
+                                - sample_mean * sample_mean;
+
+        auto const mean = double(n) * p;
+        auto const var = mean * (1 - p);
+        auto const tolerance = 5 * std::sqrt(var / double(sample_count));
+        CHECK(std::fabs(sample_mean - mean) < tolerance);
+        CHECK(std::fabs(sample_var - var) < 0.05 * var + tolerance);
+    }
+}
+
+TEST_CASE("ext::binomial_distribution - chi-square test", "[random]")
+{
+    ext::sfc64 engine {1234};
+
+    // Table inversion and BTRD, and both sides of p = 1/2.
+    std::vector<std::pair<long, double>> const params {
+        {20, 0.1}, {30, 0.9}, {200, 0.3}, {100, 0.6}
+    };
+
+    for (auto const& param : params)
+    {
+        auto const n = param.first;
+        auto const p = param.second;
+        ext::binomial_distribution<long> binomial {n, p};
+
+        auto const sample_count = 100000L;
+        std::vector<long> observed(std::size_t(n + 1), 0);
+        for (long i = 0; i < sample_count; ++i)
+            observed[std::size_t(binomial(engine))]++;
+
+        // Bins with few expected counts are merged into their neighbour.
+        double chi_square = 0;
+        int degrees = -1;
+        double expected = 0;
+        double actual = 0;
+        for (long k = 0; k <= n; ++k)
+        {
+            expected += double(sample_count) * binomial_pmf(n, p, k);
+            actual += double(observed[std::size_t(k)]);
+            if (expected >= 10 || k == n)
+            {
+                chi_square += (actual - expected) * (actual - expected) / expected;
+                degrees++;
+                expected = 0;
+                actual = 0;
+            }
+        }
+
+        // Six standard deviations above the mean of the distribution.
+        REQUIRE(degrees > 0);
+        CHECK(chi_square < degrees + 6 * std::sqrt(2.0 * degrees));
+    }
+}
+
+TEST_CASE("ext::binomial_distribution - fill", "[random]")
+{
+    for (auto const p : {0.2, 0.8})
+    {
+        for (auto const n : {10, 500})
+        {
+            ext::binomial_distribution<int> binomial {n, p};
+            std::vector<int> values(1000);
+            std::vector<int> expected(1000);
+
+            ext::sfc64 engine_1 {42};
+            ext::sfc64 engine_2 {42};
+            binomial.fill(engine_1, values);
+            for (auto& value : expected)
+                value = binomial(engine_2);
+
+            CHECK(values == expected);
+        }
+    }
+}
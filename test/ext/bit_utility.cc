@@ -35,3 +35,39 @@ TEST_CASE("ext::rotate - 16 bits")
     CHECK(ext::rotate(n, 14) == bits("0111011110101011"));
     CHECK(ext::rotate(n, 15) == bits("1110111101010110"));
 }
+
+TEST_CASE("ext::count_trailing_zeros")
+{
+    CHECK(ext::count_trailing_zeros(std::uint8_t(0x01)) == 0);
+    CHECK(ext::count_trailing_zeros(std::uint8_t(0x80)) == 7);
+    CHECK(ext::count_trailing_zeros(std::uint16_t(0x0a00)) == 9);
+    CHECK(ext::count_trailing_zeros(std::uint32_t(0x80000000u)) == 31);
+    CHECK(ext::count_trailing_zeros(std::uint32_t(0x00000c00u)) == 10);
+    CHECK(ext::count_trailing_zeros(std::uint64_t(1) << 40) == 40);
+    CHECK(ext::count_trailing_zeros(std::uint64_t(0x8000000000000000u)) == 63);
+}
+
+TEST_CASE("ext::reverse_bits")
+{
+    CHECK(ext::reverse_bits(std::uint8_t(0x01)) == 0x80u);
+    CHECK(ext::reverse_bits(std::uint8_t(0xc5)) == 0xa3u);
+    CHECK(ext::reverse_bits(std::uint16_t(0x0001)) == 0x8000u);
+    CHECK(ext::reverse_bits(std::uint32_t(0x00000001u)) == 0x80000000u);
+    CHECK(ext::reverse_bits(std::uint32_t(0x12345678u)) == 0x1e6a2c48u);
+    CHECK(ext::reverse_bits(std::uint64_t(0x00000000000000ffu))
+            == 0xff00000000000000u);
+
+    static_assert(ext::reverse_bits(std::uint16_t(0x00f1)) == 0x8f00u, "");
+
+    // Matches bit-by-bit reversal.
+    std::uint64_t x = 0x9e3779b97f4a7c15u;
+    for (int i = 0; i < 100; ++i)
+    {
+        std::uint64_t expected = 0;
+        for (int bit = 0; bit < 64; ++bit)
+            expected |= ((x >> bit) & 1u) << (63 - bit);
+        CHECK(ext::reverse_bits(x) == expected);
+        CHECK(ext::reverse_bits(std::uint32_t(x)) == std::uint32_t(expected >> 32));
+        x = x * 6364136223846793005u + 1442695040888963407u;
+    }
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
+
+#include <catch.hpp>
+
+#include <ext/array_view.hpp>
+#include <ext/brownian_paths.hpp>
+#include <ext/random_utility.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+#include <ext/sobol_engine.hpp>
+
+
+namespace
+{
+    // Checks Cov[W(s), W(t)] = min(s, t) for paths stored row by row.
+    bool has_brownian_covariance(std::vector<double> const& paths,
+                                 std::size_t steps,
+                                 double dt,
+                                 double tolerance)
+    {
+        std::size_t const count = paths.size() / steps;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            for (std::size_t j = 0; j <= i; ++j)
+            {
+                double sum = 0;
+                for (std::size_t p = 0; p < count; ++p)
+                    sum += paths[p * steps + i] * paths[p * steps + j];
+                auto const cov = sum / double(count);
+                auto const expected = dt * double(std::min(i, j) + 1);
+                if (std::fabs(cov - expected) > tolerance)
+                    return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE("ext::brownian_paths - characteristics")
+{
+    ext::brownian_paths<double> const brownian {10, 0.5};
+    CHECK(brownian.steps() == 10);
+    CHECK(brownian.dt() == 0.5);
+}
+
+TEST_CASE("ext::brownian_paths - covariance", "[random]")
+{
+    std::size_t const steps = 8;
+    double const dt = 0.25;
+    ext::brownian_paths<double> brownian {steps, dt};
+    ext::sfc64 engine;
+
+    std::vector<double> paths(100000 * steps);
+    brownian.fill(engine, paths);
+    CHECK(has_brownian_covariance(paths, steps, dt, 0.03));
+}
+
+TEST_CASE("ext::brownian_paths - antithetic pairs", "[random]")
+{
+    std::size_t const steps = 8;
+    double const dt = 0.25;
+    ext::brownian_paths<double> brownian {steps, dt};
+    ext::sfc64 engine;
+
+    std::vector<double> paths(100000 * steps);
+    brownian.fill_antithetic(engine, paths);
+
+    bool mirrored = true;
+    for (std::size_t p = 0; p < 100000; p += 2)
+    {
+        for (std::size_t i = 0; i < steps; ++i)
+            mirrored &= (paths[(p + 1) * steps + i] == -paths[p * steps + i]);
+    }
+    CHECK(mirrored);
+    CHECK(has_brownian_covariance(paths, steps, dt, 0.03));
+}
+
+TEST_CASE("ext::brownian_paths - transform")
+{
+    ext::brownian_paths<double> brownian {4, 0.25};
+    std::vector<double> path {1, 2, -1, 0};
+    brownian.transform(path);
+    CHECK(path[0] == Approx(0.5));
+    CHECK(path[1] == Approx(1.5));
+    CHECK(path[2] == Approx(1.0));
+    CHECK(path[3] == Approx(1.0));
+}
+
+TEST_CASE("ext::brownian_bridge - covariance", "[random]")
+{
+    // Includes a number of steps that is not a power of two.
+    for (std::size_t const steps : {1, 7, 16})
+    {
+        double const dt = 0.1;
+        ext::brownian_bridge<double> bridge {steps, dt};
+        ext::ziggurat_normal_distribution<double> normal;
+        ext::sfc64 engine;
+
+        std::vector<double> paths(100000 * steps);
+        normal.fill(engine, paths);
+        bridge.transform(paths);
+        CHECK(has_brownian_covariance(paths, steps, dt, 0.02));
+    }
+}
+
+TEST_CASE("ext::brownian_bridge - end point")
+{
+    // The first normal value alone determines the end point.
+    ext::brownian_bridge<double> bridge {5, 0.2};
+    std::vector<double> const normals {1.5, 0, 0, 0, 0};
+    std::vector<double> path(5);
+    bridge(normals, path);
+    CHECK(path[4] == Approx(1.5));
+    CHECK(path[0] == Approx(0.3));
+    CHECK(path[1] == Approx(0.6));
+    CHECK(path[2] == Approx(0.9));
+    CHECK(path[3] == Approx(1.2));
+}
+
+TEST_CASE("ext::brownian_bridge - quasi-random input")
+{
+    // E[max(W(1), 0)] = 1 / sqrt(2 pi)
+    std::size_t const steps = 16;
+    std::size_t const count = 1 << 12;
+    ext::brownian_bridge<double> bridge {steps, 1.0 / steps};
+    ext::sobol_engine sobol {steps};
+    ext::sfc64 engine;
+    sobol.scramble(engine, ext::sobol_scrambling::owen);
+
+    std::vector<double> paths(count * steps);
+    sobol.fill(paths);
+    for (auto& value : paths)
+        value = ext::normal_quantile(value);
+    bridge.transform(paths);
+
+    double sum = 0;
+    for (std::size_t p = 0; p < count; ++p)
+        sum += std::max(paths[p * steps + steps - 1], 0.0);
+    CHECK(std::fabs(sum / double(count) - 0.3989422804014327) < 1e-3);
+}
@@ -1,6 +1,10 @@
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
+#include <cstddef>
+
 #include <catch.hpp>
 
 #include <ext/clone_ptr.hpp>
@@ -165,3 +169,205 @@ TEST_CASE("ext::clone_ptr - swap")
         CHECK_FALSE(q);
     }
 }
+
+namespace
+{
+    int virtual_clones = 0;
+
+    struct counted_base
+    {
+        virtual
+        ~counted_base() = default;
+
+        virtual
+        int get_id() const = 0;
+
+        virtual
+        std::unique_ptr<counted_base> clone() const = 0;
+    };
+
+    struct final_derived final : counted_base
+    {
+        int id;
+
+        explicit
+        final_derived(int id)
+            : id {id}
+        {
+        }
+
+        int get_id() const override
+        {
+            return id;
+        }
+
+        std::unique_ptr<counted_base> clone() const override
+        {
+            ++virtual_clones;
+            return std::make_unique<final_derived>(*this);
+        }
+    };
+
+    struct plain
+    {
+        int id;
+    };
+
+    // Copy constructor shares the buffer while clone() duplicates it.
+    struct shallow
+    {
+        std::shared_ptr<int> buffer;
+
+        std::unique_ptr<shallow> clone() const
+        {
+            return std::make_unique<shallow>(
+                shallow {std::make_shared<int>(*buffer)});
+        }
+    };
+
+    // Opts in to placement clone.
+    struct placeable_base
+    {
+        virtual
+        ~placeable_base() = default;
+
+        virtual
+        int get_id() const = 0;
+
+        virtual
+        std::unique_ptr<placeable_base> clone() const = 0;
+
+        virtual
+        std::size_t clone_size() const = 0;
+
+        virtual
+        std::size_t clone_alignment() const = 0;
+
+        virtual
+        placeable_base* clone_into(void* storage) const = 0;
+    };
+
+    struct placeable_derived : placeable_base
+    {
+        double payload = 1.5;
+
+        int get_id() const override
+        {
+            return 7;
+        }
+
+        std::unique_ptr<placeable_base> clone() const override
+        {
+            return std::make_unique<placeable_derived>(*this);
+        }
+
+        std::size_t clone_size() const override
+        {
+            return sizeof(placeable_derived);
+        }
+
+        std::size_t clone_alignment() const override
+        {
+            return alignof(placeable_derived);
+        }
+
+        placeable_base* clone_into(void* storage) const override
+        {
+            return ::new(storage) placeable_derived(*this);
+        }
+    };
+}
+
+namespace ext
+{
+    template<>
+    struct enable_placement_clone<placeable_base> : std::true_type
+    {
+    };
+}
+
+TEST_CASE("ext::clone_traits - final type is cloned without virtual call")
+{
+    virtual_clones = 0;
+
+    ext::clone_ptr<final_derived> p {new final_derived(3)};
+    ext::clone_ptr<final_derived> q {p};
+    CHECK(q->id == 3);
+    CHECK(p.get() != q.get());
+    CHECK(virtual_clones == 0);
+    static_assert(ext::clone_traits<final_derived>::supports_placement, "");
+
+    // Through the non-final base, the virtual clone is still used.
+    ext::clone_ptr<counted_base> r {new final_derived(4)};
+    ext::clone_ptr<counted_base> s {r};
+    CHECK(s->get_id() == 4);
+    CHECK(virtual_clones == 1);
+}
+
+TEST_CASE("ext::clone_traits - clone member of non-polymorphic type is used")
+{
+    ext::clone_ptr<shallow> p {new shallow {std::make_shared<int>(5)}};
+    ext::clone_ptr<shallow> q {p};
+    CHECK(*q->buffer == 5);
+    CHECK(q->buffer != p->buffer);
+    static_assert(!ext::clone_traits<shallow>::supports_placement, "");
+}
+
+TEST_CASE("ext::clone_traits - clone returning a base pointer")
+{
+    // my_derived::clone() returns std::unique_ptr<my_base>.
+    ext::clone_ptr<my_derived> p {new my_derived(6)};
+    ext::clone_ptr<my_derived> q {p};
+    CHECK(q->id == 6);
+    CHECK(p.get() != q.get());
+}
+
+TEST_CASE("ext::clone_traits - non-polymorphic type is copy constructed")
+{
+    ext::clone_ptr<plain> p {new plain {5}};
+    ext::clone_ptr<plain> q {p};
+    CHECK(q->id == 5);
+    CHECK(p.get() != q.get());
+}
+
+TEST_CASE("ext::clone_traits - placement clone")
+{
+    SECTION("static type")
+    {
+        using traits = ext::clone_traits<plain>;
+        static_assert(traits::supports_placement, "");
+
+        plain const original {9};
+        CHECK(traits::clone_size(original) == sizeof(plain));
+        CHECK(traits::clone_alignment(original) == alignof(plain));
+
+        std::aligned_storage_t<sizeof(plain), alignof(plain)> storage;
+        plain* const copy = traits::clone_into(original, &storage);
+        CHECK(copy->id == 9);
+    }
+
+    SECTION("trait is usable as an lvalue")
+    {
+        bool const& supported = ext::clone_traits<plain>::supports_placement;
+        CHECK(supported);
+    }
+
+    SECTION("opted-in polymorphic type")
+    {
+        using traits = ext::clone_traits<placeable_base>;
+        static_assert(traits::supports_placement, "");
+        static_assert(!ext::clone_traits<my_base>::supports_placement, "");
+
+        placeable_derived const original;
+        placeable_base const& base = original;
+        CHECK(traits::clone_size(base) == sizeof(placeable_derived));
+        CHECK(traits::clone_alignment(base) == alignof(placeable_derived));
+
+        std::aligned_storage_t<sizeof(placeable_derived),
+                               alignof(placeable_derived)> storage;
+        placeable_base* const copy = traits::clone_into(base, &storage);
+        CHECK(copy->get_id() == 7);
+        CHECK(static_cast<placeable_derived*>(copy)->payload == 1.5);
+        copy->~placeable_base();
+    }
+}
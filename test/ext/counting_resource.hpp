@@ -0,0 +1,40 @@
+#ifndef EXT_TEST_COUNTING_RESOURCE_HPP
+#define EXT_TEST_COUNTING_RESOURCE_HPP
+
+#include <cstddef>
+
+#include <ext/memory_resource.hpp>
+
+
+namespace test
+{
+    // Memory resource that counts allocations served by the global heap.
+    struct counting_resource : ext::memory_resource
+    {
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+        std::size_t bytes = 0;
+
+      private:
+        void* do_allocate(std::size_t size, std::size_t alignment) override
+        {
+            ++allocations;
+            bytes += size;
+            return ext::new_delete_resource()->allocate(size, alignment);
+        }
+
+        void do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override
+        {
+            ++deallocations;
+            bytes -= size;
+            ext::new_delete_resource()->deallocate(ptr, size, alignment);
+        }
+
+        bool do_is_equal(ext::memory_resource const& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,214 @@
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+#include <catch.hpp>
+
+#include <ext/cow_polymorphic_value.hpp>
+#include <ext/lifetime_utility.hpp>
+#include <ext/memory_resource.hpp>
+
+#include "counting_resource.hpp"
+
+namespace
+{
+    struct my_base
+    {
+        virtual long id() const = 0;
+        virtual long life() const = 0;
+        virtual void set_id(long id) = 0;
+
+        bool operator==(my_base const& other) const
+        {
+            return id() == other.id();
+        }
+    };
+
+    struct my_derived : my_base
+    {
+        my_derived(long id)
+            : id_ {id}
+        {
+        }
+
+        long id() const override
+        {
+            return id_;
+        }
+
+        long life() const override
+        {
+            return life_.count();
+        }
+
+        void set_id(long id) override
+        {
+            id_ = id;
+        }
+
+      private:
+        long id_;
+        ext::copy_counter life_;
+    };
+
+    struct mixin
+    {
+        virtual ~mixin() = default;
+        long mixin_data = 0;
+    };
+
+    struct offset_derived : mixin, my_derived
+    {
+        offset_derived(long id)
+            : my_derived {id}
+        {
+        }
+    };
+}
+
+TEST_CASE("ext::cow_polymorphic_value - initialization")
+{
+    ext::cow_polymorphic_value<my_base> const v {my_derived {123}};
+    CHECK(v->id() == 123);
+    CHECK(v.use_count() == 1);
+}
+
+TEST_CASE("ext::cow_polymorphic_value - copy shares content")
+{
+    ext::cow_polymorphic_value<my_base> const v {my_derived {123}};
+    ext::cow_polymorphic_value<my_base> const w {v};
+    CHECK(&v.value() == &w.value());
+    CHECK(v.use_count() == 2);
+    CHECK(w->life() == 1); // single object
+}
+
+TEST_CASE("ext::cow_polymorphic_value - mutable access clones shared content")
+{
+    ext::cow_polymorphic_value<my_base> v {my_derived {123}};
+    ext::cow_polymorphic_value<my_base> w {v};
+
+    w->set_id(456);
+    CHECK(v->id() == 123);
+    CHECK(w->id() == 456);
+    CHECK(v.use_count() == 1);
+    CHECK(w.use_count() == 1);
+    CHECK(v->life() == 2);
+
+    // Unshared content is not cloned again.
+    auto const address = &w.value();
+    w->set_id(789);
+    CHECK(&w.value() == address);
+}
+
+TEST_CASE("ext::cow_polymorphic_value - const access does not clone")
+{
+    ext::cow_polymorphic_value<my_base> v {my_derived {123}};
+    ext::cow_polymorphic_value<my_base> w {v};
+
+    auto const& cw = w;
+    CHECK(cw->id() == 123);
+    CHECK(cw.value().id() == 123);
+    CHECK(cw.as<my_derived>().id() == 123);
+    CHECK(w.use_count() == 2);
+}
+
+TEST_CASE("ext::cow_polymorphic_value - as")
+{
+    ext::cow_polymorphic_value<my_base> v {offset_derived {123}};
+    ext::cow_polymorphic_value<my_base> w {v};
+
+    offset_derived& derived = w.as<offset_derived>();
+    derived.mixin_data = 1;
+    CHECK(v.as<offset_derived>().mixin_data == 0);
+    CHECK(w.as<offset_derived>().mixin_data == 1);
+    CHECK(w->id() == 123);
+}
+
+TEST_CASE("ext::cow_polymorphic_value - move")
+{
+    ext::cow_polymorphic_value<my_base> v {my_derived {123}};
+    ext::cow_polymorphic_value<my_base> w {std::move(v)};
+    CHECK(w->id() == 123);
+    CHECK(w.use_count() == 1);
+    CHECK(v.use_count() == 0);
+
+    ext::cow_polymorphic_value<my_base> x {my_derived {456}};
+    x = std::move(w);
+    CHECK(x->id() == 123);
+}
+
+TEST_CASE("ext::cow_polymorphic_value - assignment")
+{
+    ext::cow_polymorphic_value<my_base> v {my_derived {123}};
+    ext::cow_polymorphic_value<my_base> w {my_derived {456}};
+
+    w = v;
+    CHECK(v.use_count() == 2);
+    CHECK(w.value().id() == 123);
+
+    v = my_derived {789};
+    CHECK(v->id() == 789);
+    CHECK(w->id() == 123);
+    CHECK(w.use_count() == 1);
+
+    v.emplace<my_derived>(10);
+    CHECK(v->id() == 10);
+}
+
+TEST_CASE("ext::cow_polymorphic_value - equality comparison")
+{
+    ext::cow_polymorphic_value<my_base> const a {my_derived {123}};
+    ext::cow_polymorphic_value<my_base> const b {my_derived {123}};
+    ext::cow_polymorphic_value<my_base> const c {my_derived {456}};
+
+    CHECK(a == b);
+    CHECK(a != c);
+}
+
+TEST_CASE("ext::cow_polymorphic_value - memory resource")
+{
+    test::counting_resource resource;
+    {
+        ext::cow_polymorphic_value<my_base> v {
+            std::allocator_arg, &resource, my_derived {123}};
+        CHECK(resource.allocations == 1);
+        CHECK(resource.bytes == 2 * sizeof(void*) + sizeof(long) +
+                                sizeof(my_derived));
+
+        std::vector<ext::cow_polymorphic_value<my_base>> copies(10, v);
+        CHECK(resource.allocations == 1);
+
+        copies[0]->set_id(456);
+        CHECK(resource.allocations == 2);
+
+        copies[1].emplace<my_derived>(789);
+        copies[2] = my_derived {10};
+        CHECK(resource.allocations == 4);
+    }
+    CHECK(resource.deallocations == 4);
+}
+
+TEST_CASE("ext::cow_polymorphic_value - concurrent copies")
+{
+    ext::cow_polymorphic_value<my_base> const v {my_derived {123}};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&v] {
+            for (int i = 0; i < 1000; ++i)
+            {
+                ext::cow_polymorphic_value<my_base> copy {v};
+                copy->set_id(i);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    CHECK(v.use_count() == 1);
+    CHECK(v->id() == 123);
+}
@@ -0,0 +1,180 @@
+#include <random>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <catch.hpp>
+
+#include <ext/array_view.hpp>
+#include <ext/engine_array.hpp>
+#include <ext/random_utility.hpp>
+#include <ext/seed_seq_fe.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+
+
+namespace
+{
+    // Seed sequence that hands out stored values.
+    struct replay_seed
+    {
+        using result_type = std::uint32_t;
+
+        std::uint32_t const* values;
+
+        std::size_t size() const
+        {
+            return 0;
+        }
+
+        template<typename It>
+        void generate(It first, It last)
+        {
+            for (; first != last; ++first)
+                *first = *values++;
+        }
+    };
+}
+
+TEST_CASE("ext::engine_array - construction")
+{
+    SECTION("default constructed array is empty")
+    {
+        ext::engine_array<ext::sfc32> engines;
+        CHECK(engines.size() == 0);
+    }
+
+    SECTION("engines are equal to scalar engines with the same seed")
+    {
+        ext::engine_array<ext::sfc32> engines {5, 123};
+        CHECK(engines.size() == 5);
+        for (std::size_t i = 0; i < engines.size(); ++i)
+            CHECK(engines.get(i) == ext::sfc32 {123});
+    }
+
+    SECTION("seed sequence gives distinct engines")
+    {
+        ext::seed_seq_fe<4> seed {1, 2, 3};
+        ext::engine_array<ext::sfc64> engines {1000, seed};
+        CHECK(engines.get(0) != engines.get(1));
+        CHECK(engines.get(998) != engines.get(999));
+
+        ext::seed_seq_fe<4> same_seed {1, 2, 3};
+        CHECK((ext::engine_array<ext::sfc64> {1000, same_seed}) == engines);
+    }
+
+    SECTION("seed sequence fills the state as one array")
+    {
+        ext::seed_seq_fe<4> seed {4, 5};
+        ext::engine_array<ext::sfc32> engines {200, seed};
+
+        ext::seed_seq_fe<4> same_seed {4, 5};
+        std::vector<std::uint32_t> state(3 * 200);
+        ext::seed_state(same_seed, ext::array_view<std::uint32_t>(state));
+
+        for (std::size_t i = 0; i < 200; ++i)
+        {
+            replay_seed replay {&state[3 * i]};
+            CHECK(engines.get(i) == ext::sfc32 {replay});
+        }
+    }
+
+    SECTION("seeding single engine")
+    {
+        ext::engine_array<ext::sfc32> engines {3};
+        engines.seed(1, 42);
+        CHECK(engines.get(0) == ext::sfc32 {});
+        CHECK(engines.get(1) == ext::sfc32 {42});
+
+        std::seed_seq seed {7, 8};
+        engines.seed(2, seed);
+        std::seed_seq same_seed {7, 8};
+        CHECK(engines.get(2) == ext::sfc32 {same_seed});
+    }
+}
+
+TEST_CASE("ext::engine_array - generation")
+{
+    std::size_t const n = 37;
+
+    std::vector<ext::sfc32> scalars;
+    ext::engine_array<ext::sfc32> engines {n};
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        scalars.emplace_back(std::uint32_t(i));
+        engines.seed(i, std::uint32_t(i));
+    }
+
+    SECTION("generate steps all engines")
+    {
+        std::vector<std::uint32_t> output(n);
+        for (int round = 0; round < 3; ++round)
+        {
+            engines.generate(output);
+            for (std::size_t i = 0; i < n; ++i)
+                CHECK(output[i] == scalars[i]());
+        }
+    }
+
+    SECTION("generate_masked steps selected engines")
+    {
+        bool mask[n];
+        for (std::size_t i = 0; i < n; ++i)
+            mask[i] = (i % 3 == 0);
+
+        std::vector<std::uint32_t> output(n, 0xdeadbeef);
+        engines.generate_masked(ext::array_view<bool const>(mask, n), output);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (mask[i])
+                CHECK(output[i] == scalars[i]());
+            else
+                CHECK(output[i] == 0xdeadbeef);
+            CHECK(engines.get(i) == scalars[i]);
+        }
+    }
+
+    SECTION("generate_indexed steps engines in order")
+    {
+        std::vector<std::size_t> const indices {4, 0, 4, 36};
+        std::vector<std::uint32_t> output(indices.size());
+        engines.generate_indexed(indices, output);
+
+        CHECK(output[0] == scalars[4]());
+        CHECK(output[1] == scalars[0]());
+        CHECK(output[2] == scalars[4]());
+        CHECK(output[3] == scalars[36]());
+        CHECK(engines.get(4) == scalars[4]);
+    }
+
+    SECTION("discard advances all engines")
+    {
+        engines.discard(10);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            scalars[i].discard(10);
+            CHECK(engines.get(i) == scalars[i]);
+        }
+    }
+}
+
+TEST_CASE("ext::engine_array - reference")
+{
+    ext::engine_array<ext::sfc64> engines {4, 9};
+    ext::sfc64 scalar {9};
+
+    auto engine = engines[2];
+    CHECK(engine() == scalar());
+    engine.discard(5);
+    scalar.discard(5);
+    CHECK(ext::sfc64(engine) == scalar);
+    CHECK(engines.get(1) == ext::sfc64 {9});
+
+    std::uniform_int_distribution<int> dist {1, 6};
+    auto const value = dist(engine);
+    CHECK(value == dist(scalar));
+
+    engines[0] = ext::sfc64 {77};
+    CHECK(engines.get(0) == ext::sfc64 {77});
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <catch.hpp>
+
+#include <ext/memory_resource.hpp>
+
+#include "counting_resource.hpp"
+
+
+namespace
+{
+    bool is_aligned(void* ptr, std::size_t alignment)
+    {
+        return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+    }
+}
+
+TEST_CASE("ext::new_delete_resource")
+{
+    auto const resource = ext::new_delete_resource();
+    CHECK(resource == ext::new_delete_resource());
+    CHECK(*resource == *ext::new_delete_resource());
+
+    void* const ptr = resource->allocate(100, alignof(double));
+    CHECK(ptr != nullptr);
+    CHECK(is_aligned(ptr, alignof(double)));
+    resource->deallocate(ptr, 100, alignof(double));
+
+    SECTION("over-aligned storage")
+    {
+        for (std::size_t alignment : {64, 256, 4096})
+        {
+            auto const bytes = static_cast<char*>(resource->allocate(100, alignment));
+            CHECK(is_aligned(bytes, alignment));
+            std::fill(bytes, bytes + 100, 'x');
+            resource->deallocate(bytes, 100, alignment);
+        }
+    }
+}
+
+TEST_CASE("ext::monotonic_buffer_resource")
+{
+    test::counting_resource upstream;
+
+    SECTION("allocates aligned storage")
+    {
+        ext::monotonic_buffer_resource arena {64, &upstream};
+        void* const a = arena.allocate(1, 1);
+        void* const b = arena.allocate(8, 8);
+        void* const c = arena.allocate(16, 16);
+        CHECK(is_aligned(b, 8));
+        CHECK(is_aligned(c, 16));
+        CHECK(a != b);
+        CHECK(b != c);
+    }
+
+    SECTION("grows geometrically")
+    {
+        ext::monotonic_buffer_resource arena {64, &upstream};
+        for (int i = 0; i < 1000; ++i)
+            arena.allocate(16, 8);
+        CHECK(upstream.allocations > 1);
+        CHECK(upstream.allocations < 12);
+    }
+
+    SECTION("serves large requests")
+    {
+        ext::monotonic_buffer_resource arena {64, &upstream};
+        void* const ptr = arena.allocate(10000, 8);
+        CHECK(ptr != nullptr);
+        CHECK(upstream.bytes >= 10000);
+    }
+
+    SECTION("deallocate does nothing and release frees everything")
+    {
+        ext::monotonic_buffer_resource arena {64, &upstream};
+        void* const ptr = arena.allocate(100, 8);
+        arena.deallocate(ptr, 100, 8);
+        CHECK(upstream.deallocations == 0);
+
+        arena.release();
+        CHECK(upstream.deallocations == upstream.allocations);
+        CHECK(upstream.bytes == 0);
+
+        arena.allocate(100, 8);
+        CHECK(upstream.bytes > 0);
+    }
+
+    SECTION("destructor frees everything")
+    {
+        {
+            ext::monotonic_buffer_resource arena {64, &upstream};
+            arena.allocate(100, 8);
+            arena.allocate(1000, 8);
+        }
+        CHECK(upstream.allocations > 0);
+        CHECK(upstream.bytes == 0);
+    }
+
+    SECTION("uses initial buffer first")
+    {
+        alignas(16) unsigned char buffer[256];
+        ext::monotonic_buffer_resource arena {buffer, sizeof buffer, &upstream};
+
+        auto const ptr = static_cast<unsigned char*>(arena.allocate(100, 8));
+        CHECK(ptr >= buffer);
+        CHECK(ptr + 100 <= buffer + sizeof buffer);
+        CHECK(upstream.allocations == 0);
+
+        arena.allocate(200, 8);
+        CHECK(upstream.allocations == 1);
+    }
+}
+
+TEST_CASE("ext::new_object")
+{
+    test::counting_resource resource;
+
+    auto const ptr = ext::new_object<std::vector<int>>(&resource, 3, 42);
+    CHECK(resource.allocations == 1);
+    CHECK(ptr->size() == 3);
+    CHECK((*ptr)[2] == 42);
+
+    ext::delete_object(&resource, ptr);
+    CHECK(resource.deallocations == 1);
+    CHECK(resource.bytes == 0);
+}
@@ -0,0 +1,96 @@
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
+
+#include <catch.hpp>
+
+#include <ext/array_view.hpp>
+#include <ext/multivariate_normal.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+
+
+TEST_CASE("ext::multivariate_normal - cholesky factor")
+{
+    std::vector<double> const mean {1, 2, 3};
+    std::vector<double> const cov {
+        4, 2, 2,
+        2, 5, 3,
+        2, 3, 6
+    };
+    ext::multivariate_normal<double> const normal {mean, cov};
+
+    CHECK(normal.dimension() == 3);
+    CHECK(normal.mean().equals(mean));
+
+    // Reconstruct the covariance matrix from the packed factor.
+    auto const factor = normal.cholesky_factor();
+    REQUIRE(factor.size() == 6);
+    auto const l = [&](std::size_t i, std::size_t j) {
+        return j <= i ? factor[i * (i + 1) / 2 + j] : 0.0;
+    };
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            double sum = 0;
+            for (std::size_t k = 0; k < 3; ++k)
+                sum += l(i, k) * l(j, k);
+            CHECK(sum == Approx(cov[i * 3 + j]));
+        }
+    }
+}
+
+TEST_CASE("ext::multivariate_normal - moment test", "[random]")
+{
+    std::size_t const dim = 12;
+    std::vector<double> mean(dim);
+    std::vector<double> cov(dim * dim);
+    for (std::size_t i = 0; i < dim; ++i)
+    {
+        mean[i] = double(i);
+        for (std::size_t j = 0; j < dim; ++j)
+            cov[i * dim + j] = std::pow(0.5, std::fabs(double(i) - double(j)));
+    }
+    ext::multivariate_normal<double> normal {mean, cov};
+
+    std::size_t const count = 100000;
+    std::vector<double> samples(count * dim);
+    ext::sfc64 engine;
+    normal.fill(engine, samples);
+
+    for (std::size_t i = 0; i < dim; ++i)
+    {
+        double sum = 0;
+        for (std::size_t s = 0; s < count; ++s)
+            sum += samples[s * dim + i];
+        CHECK(std::fabs(sum / double(count) - mean[i]) < 0.02);
+    }
+
+    for (std::size_t i = 0; i < dim; ++i)
+    {
+        for (std::size_t j = 0; j <= i; ++j)
+        {
+            double sum = 0;
+            for (std::size_t s = 0; s < count; ++s)
+                sum += (samples[s * dim + i] - mean[i])
+                       * (samples[s * dim + j] - mean[j]);
+            CHECK(std::fabs(sum / double(count) - cov[i * dim + j]) < 0.03);
+        }
+    }
+}
+
+TEST_CASE("ext::multivariate_normal - single sample")
+{
+    std::vector<double> const mean {0, 0};
+    std::vector<double> const cov {1, 0, 0, 1};
+    ext::multivariate_normal<double> normal {mean, cov};
+
+    std::vector<double> sample_1(2);
+    std::vector<double> sample_2(2);
+    ext::sfc64 engine_1 {1};
+    ext::sfc64 engine_2 {1};
+    normal(engine_1, sample_1);
+    normal.fill(engine_2, sample_2);
+    CHECK(sample_1 == sample_2);
+}
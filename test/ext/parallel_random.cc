@@ -0,0 +1,149 @@
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <catch.hpp>
+
+#include <ext/array_view.hpp>
+#include <ext/parallel_random.hpp>
+#include <ext/seed_seq_fe.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+
+
+TEST_CASE("ext::make_chunk_engine")
+{
+    SECTION("is deterministic")
+    {
+        CHECK(ext::make_chunk_engine(1, 2) == ext::make_chunk_engine(1, 2));
+    }
+
+    SECTION("gives distinct streams to chunks and seeds")
+    {
+        auto const base = ext::make_chunk_engine(1, 0);
+        CHECK(ext::make_chunk_engine(1, 1) != base);
+        CHECK(ext::make_chunk_engine(2, 0) != base);
+        CHECK(ext::make_chunk_engine(1, std::uint64_t(1) << 32) != base);
+        CHECK(ext::make_chunk_engine(std::uint64_t(1) << 32 | 1, 0) != base);
+    }
+
+    SECTION("is separated from other uses of the same seed words")
+    {
+        ext::seed_seq_fe<4> plain {1, 0, 2, 0};
+        CHECK(ext::make_chunk_engine(1, 2) != ext::sfc64 {plain});
+    }
+}
+
+TEST_CASE("ext::parallel_generate")
+{
+    auto const fill = [](ext::sfc64& engine,
+                         ext::array_view<std::uint64_t> chunk,
+                         std::size_t offset) {
+        for (auto& value : chunk)
+            value = engine() ^ offset;
+    };
+
+    auto const generate = [&](unsigned thread_count) {
+        ext::parallel_random_options options;
+        options.chunk_size = 100;
+        options.thread_count = thread_count;
+
+        std::vector<std::uint64_t> values(1050);
+        ext::parallel_generate(ext::array_view<std::uint64_t>(values), 42,
+                               fill, options);
+        return values;
+    };
+
+    SECTION("fills chunks from chunk engines")
+    {
+        auto const values = generate(1);
+
+        auto engine = ext::make_chunk_engine(42, 10);
+        CHECK(values[1000] == (engine() ^ 1000));
+        CHECK(values[1001] == (engine() ^ 1000));
+
+        engine = ext::make_chunk_engine(42, 0);
+        CHECK(values[0] == engine());
+    }
+
+    SECTION("is independent of thread count")
+    {
+        auto const expected = generate(1);
+        CHECK(generate(2) == expected);
+        CHECK(generate(7) == expected);
+        CHECK(generate(32) == expected);
+    }
+
+    SECTION("does nothing on empty view")
+    {
+        ext::parallel_generate(ext::array_view<std::uint64_t>(), 42, fill);
+    }
+}
+
+TEST_CASE("ext::parallel_for_random")
+{
+    auto const sum = [](ext::sfc64& engine, std::size_t begin, std::size_t end) {
+        double result = 0;
+        for (auto i = begin; i < end; ++i)
+            result += double(engine() >> 11) / 9007199254740992.0;
+        return result;
+    };
+
+    auto const run = [&](std::size_t count, unsigned thread_count) {
+        ext::parallel_random_options options;
+        options.chunk_size = 64;
+        options.thread_count = thread_count;
+        return ext::parallel_for_random(count, 7, 0.0, sum,
+                                        std::plus<double>(), options);
+    };
+
+    SECTION("is bit-identical across thread counts")
+    {
+        auto const expected = run(10000, 1);
+        CHECK(run(10000, 3) == expected);
+        CHECK(run(10000, 8) == expected);
+        CHECK(run(10000, 0) == expected);
+    }
+
+    SECTION("reduces chunk results in pairwise order")
+    {
+        ext::parallel_random_options options;
+        options.chunk_size = 1;
+        options.thread_count = 2;
+
+        auto const order = ext::parallel_for_random(
+            5, 0, std::vector<std::size_t> {},
+            [](ext::sfc64&, std::size_t begin, std::size_t) {
+                return std::vector<std::size_t> {begin};
+            },
+            [](std::vector<std::size_t> lhs, std::vector<std::size_t> const& rhs) {
+                lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+                return lhs;
+            },
+            options);
+        CHECK(order == (std::vector<std::size_t> {0, 1, 2, 3, 4}));
+    }
+
+    SECTION("returns initial value on empty range")
+    {
+        CHECK(ext::parallel_for_random(0, 7, 1.5, sum, std::plus<double>()) == 1.5);
+    }
+
+    SECTION("propagates exception")
+    {
+        ext::parallel_random_options options;
+        options.chunk_size = 1;
+        options.thread_count = 4;
+
+        auto const throwing = [](ext::sfc64&, std::size_t begin, std::size_t) {
+            if (begin == 13)
+                throw std::runtime_error("chunk failed");
+            return 0;
+        };
+        CHECK_THROWS_AS(
+            ext::parallel_for_random(100, 7, 0, throwing, std::plus<int>(), options),
+            std::runtime_error const&);
+    }
+}
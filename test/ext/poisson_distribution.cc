@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <vector>
+
+#include <cmath>
+
+#include <catch.hpp>
+
+#include <ext/array_view.hpp>
+#include <ext/poisson_distribution.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+
+
+namespace
+{
+    double poisson_pmf(double mean, long k)
+    {
+        return std::exp(-mean + double(k) * std::log(mean) - std::lgamma(double(k) + 1));
+    }
+
+    // Returns its maximum a few times, which drives u to the largest value
+    // below one, where the table sum may round short of it.
+    struct max_engine
+    {
+        using result_type = unsigned;
+
+        static constexpr unsigned min()
+        {
+            return 0;
+        }
+
+        static constexpr unsigned max()
+        {
+            return 0xFFFFFFFFu;
+        }
+
+        unsigned operator()()
+        {
+            return calls++ < 4 ? max() : 0;
+        }
+
+        int calls = 0;
+    };
+}
+
+TEST_CASE("ext::poisson_distribution - characteristics")
+{
+    ext::poisson_distribution<int> const poisson {2.5};
+    CHECK(poisson.mean() == 2.5);
+    CHECK(poisson.min() == 0);
+    CHECK(poisson == (ext::poisson_distribution<int> {2.5}));
+    CHECK(poisson != (ext::poisson_distribution<int> {3.5}));
+}
+
+TEST_CASE("ext::poisson_distribution - moment test", "[random]")
+{
+    ext::sfc64 engine;
+
+    // Covers both table inversion and PTRS.
+    std::vector<double> const means {0.1, 1, 4.5, 9.9, 10, 27.3, 1000, 1e6};
+
+    for (auto const mean : means)
+    {
+        ext::poisson_distribution<long> poisson {mean};
+
+        auto const sample_count = 200000uL;
+        double sum = 0;
+        double sum_sq = 0;
+        long min = 0;
+        for (auto i = 0uL; i < sample_count; ++i)
+        {
+            auto const k = poisson(engine);
+            auto const x = double(k);
+            min = std::min(min, k);
+            sum += x;
+            sum_sq += x * x;
+        }
+        CHECK(min == 0);
+        auto const sample_mean = sum / double(sample_count);
+        auto const sample_var = sum_sq / double(sample_count)
+                                - sample_mean * sample_mean;
+
+        // Mean and variance are both equal to the parameter.
+        auto const tolerance = 5 * std::sqrt(mean / double(sample_count));
+        CHECK(std::fabs(sample_mean - mean) < tolerance);
+        CHECK(std::fabs(sample_var - mean) < 0.05 * mean + tolerance);
+    }
+}
+
+TEST_CASE("ext::poisson_distribution - chi-square test", "[random]")
+{
+    ext::sfc64 engine {1234};
+
+    // Table inversion and PTRS.
+    for (auto const mean : {0.5, 4.5, 27.3})
+    {
+        ext::poisson_distribution<long> poisson {mean};
+
+        auto const sample_count = 100000L;
+        auto const bin_count = long(mean + 10 * std::sqrt(mean)) + 10;
+        std::vector<long> observed(std::size_t(bin_count), 0);
+        long max = 0;
+        for (long i = 0; i < sample_count; ++i)
+        {
+            auto const k = poisson(engine);
+            max = std::max(max, k);
+            observed[std::size_t(std::min(k, bin_count - 1))]++;
+        }
+        CHECK(max < bin_count);
+
+        // Bins with few expected counts are merged into their neighbour.
+        double chi_square = 0;
+        int degrees = -1;
+        double expected = 0;
+        double actual = 0;
+        for (long k = 0; k < bin_count; ++k)
+        {
+            expected += double(sample_count) * poisson_pmf(mean, k);
+            actual += double(observed[std::size_t(k)]);
+            if (expected >= 10 || k == bin_count - 1)
+            {
+                chi_square += (actual - expected) * (actual - expected) / expected;
+                degrees++;
+                expected = 0;
+                actual = 0;
+            }
+        }
+
+        // Six standard deviations above the mean of the distribution.
+        REQUIRE(degrees > 0);
+        CHECK(chi_square < degrees + 6 * std::sqrt(2.0 * degrees));
+    }
+}
+
+TEST_CASE("ext::poisson_distribution - tail is bounded", "[random]")
+{
+    for (auto const mean : {0.1, 1.0, 9.9})
+    {
+        max_engine engine;
+        ext::poisson_distribution<long> const poisson {mean};
+        CHECK(poisson(engine) <= 80);
+    }
+}
+
+TEST_CASE("ext::poisson_distribution - fill", "[random]")
+{
+    for (auto const mean : {3.0, 50.0})
+    {
+        ext::poisson_distribution<int> poisson {mean};
+        std::vector<int> values(1000);
+        std::vector<int> expected(1000);
+
+        ext::sfc64 engine_1 {42};
+        ext::sfc64 engine_2 {42};
+        poisson.fill(engine_1, values);
+        for (auto& value : expected)
+            value = poisson(engine_2);
+
+        CHECK(values == expected);
+    }
+}
@@ -0,0 +1,242 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch.hpp>
+
+#include <ext/poly_collection.hpp>
+
+
+namespace
+{
+    struct shape
+    {
+        virtual ~shape() = default;
+        virtual int sides() const = 0;
+        virtual std::string name() const = 0;
+    };
+
+    struct triangle final : shape
+    {
+        int sides() const override
+        {
+            return 3;
+        }
+
+        std::string name() const override
+        {
+            return "triangle";
+        }
+    };
+
+    struct square final : shape
+    {
+        explicit square(int id = 0)
+            : id {id}
+        {
+        }
+
+        int sides() const override
+        {
+            return 4;
+        }
+
+        std::string name() const override
+        {
+            return "square";
+        }
+
+        int id;
+    };
+
+    struct tagged
+    {
+        virtual ~tagged() = default;
+        long tag = 7;
+    };
+
+    // Base subobject is not at the start of the object.
+    struct pentagon final : tagged, shape
+    {
+        int sides() const override
+        {
+            return 5;
+        }
+
+        std::string name() const override
+        {
+            return "pentagon";
+        }
+    };
+
+    // Counts how an object is passed to the visitor.
+    struct visitor
+    {
+        int* static_calls;
+        int* base_calls;
+
+        void operator()(triangle const&) const
+        {
+            ++*static_calls;
+        }
+
+        void operator()(square const&) const
+        {
+            ++*static_calls;
+        }
+
+        void operator()(shape const&) const
+        {
+            ++*base_calls;
+        }
+    };
+}
+
+TEST_CASE("ext::poly_collection - default construction")
+{
+    ext::poly_collection<shape> shapes;
+    CHECK(shapes.empty());
+    CHECK(shapes.size() == 0);
+    CHECK(shapes.count<square>() == 0);
+}
+
+TEST_CASE("ext::poly_collection - insert groups objects by type")
+{
+    ext::poly_collection<shape> shapes;
+    shapes.insert(square {1});
+    shapes.insert(triangle {});
+    shapes.insert(square {2});
+    shapes.emplace<square>(3);
+
+    CHECK(shapes.size() == 4);
+    CHECK(shapes.count<square>() == 3);
+    CHECK(shapes.count<triangle>() == 1);
+    CHECK(shapes.count<pentagon>() == 0);
+
+    auto const squares = shapes.segment_view<square>();
+    REQUIRE(squares.size() == 3);
+    CHECK(squares[0].id == 1);
+    CHECK(squares[1].id == 2);
+    CHECK(squares[2].id == 3);
+
+    CHECK(shapes.segment_view<pentagon>().empty());
+}
+
+TEST_CASE("ext::poly_collection - insert by dynamic type")
+{
+    struct base
+    {
+        virtual ~base() = default;
+    };
+
+    struct middle : base
+    {
+    };
+
+    struct leaf final : middle
+    {
+    };
+
+    ext::poly_collection<base> objects;
+    middle const m;
+    objects.insert(m);
+    CHECK(objects.count<middle>() == 1);
+
+    // The base type itself is inserted with emplace.
+    objects.emplace<base>();
+    CHECK(objects.count<base>() == 1);
+
+    objects.insert(leaf {});
+    CHECK(objects.count<leaf>() == 1);
+    CHECK(objects.size() == 3);
+}
+
+TEST_CASE("ext::poly_collection - for_each visits all objects as base")
+{
+    ext::poly_collection<shape> shapes;
+    shapes.insert(square {});
+    shapes.insert(triangle {});
+    shapes.insert(pentagon {});
+    shapes.insert(square {});
+
+    int sides = 0;
+    std::vector<std::string> names;
+    shapes.for_each([&](shape& s) {
+        sides += s.sides();
+        names.push_back(s.name());
+    });
+    CHECK(sides == 16);
+    CHECK(names == (std::vector<std::string> {
+        "square", "square", "triangle", "pentagon"}));
+}
+
+TEST_CASE("ext::poly_collection - for_each passes static types")
+{
+    ext::poly_collection<shape> shapes;
+    shapes.insert(square {});
+    shapes.insert(triangle {});
+    shapes.insert(pentagon {});
+    shapes.insert(triangle {});
+
+    int static_calls = 0;
+    int base_calls = 0;
+    visitor const visit {&static_calls, &base_calls};
+
+    SECTION("mutable")
+    {
+        shapes.for_each<triangle, square>(visit);
+        CHECK(static_calls == 3);
+        CHECK(base_calls == 1);
+    }
+
+    SECTION("const")
+    {
+        auto const& const_shapes = shapes;
+        const_shapes.for_each<triangle>(visit);
+        CHECK(static_calls == 2);
+        CHECK(base_calls == 2);
+    }
+
+    SECTION("generic lambda")
+    {
+        int sides = 0;
+        shapes.for_each<triangle, square, pentagon>([&](auto& s) {
+            sides += s.sides();
+        });
+        CHECK(sides == 15);
+    }
+}
+
+TEST_CASE("ext::poly_collection - copy and move")
+{
+    ext::poly_collection<shape> shapes;
+    shapes.insert(square {5});
+    shapes.insert(pentagon {});
+
+    ext::poly_collection<shape> copy {shapes};
+    CHECK(copy.size() == 2);
+    CHECK(copy.segment_view<square>()[0].id == 5);
+    CHECK(&copy.segment_view<square>()[0] != &shapes.segment_view<square>()[0]);
+
+    int sides = 0;
+    copy.for_each([&](shape& s) { sides += s.sides(); });
+    CHECK(sides == 9);
+
+    ext::poly_collection<shape> moved {std::move(copy)};
+    CHECK(moved.size() == 2);
+    CHECK(moved.segment_view<square>()[0].id == 5);
+}
+
+TEST_CASE("ext::poly_collection - clear")
+{
+    ext::poly_collection<shape> shapes;
+    shapes.insert(square {});
+    shapes.insert(triangle {});
+    shapes.clear();
+    CHECK(shapes.empty());
+    CHECK(shapes.count<square>() == 0);
+
+    shapes.insert(square {9});
+    CHECK(shapes.size() == 1);
+    CHECK(shapes.segment_view<square>()[0].id == 9);
+}
@@ -1,8 +1,19 @@
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
 #include <catch.hpp>
 
 #include <ext/lifetime_utility.hpp>
+#include <ext/memory_resource.hpp>
 #include <ext/polymorphic_value.hpp>
 
+#include "counting_resource.hpp"
+
 namespace
 {
     struct my_base
@@ -208,3 +219,557 @@ TEST_CASE("ext::polymorphic_value - equality comparison")
     CHECK(c != b);
     CHECK(c == c);
 }
+
+TEST_CASE("ext::polymorphic_value - memory resource")
+{
+    test::counting_resource resource;
+
+    SECTION("content is allocated from resource")
+    {
+        {
+            ext::polymorphic_value<my_base> v {
+                std::allocator_arg, &resource, my_derived {123}};
+            CHECK(resource.allocations == 1);
+            CHECK(v->id() == 123);
+        }
+        CHECK(resource.deallocations == 1);
+    }
+
+    SECTION("copy propagates resource")
+    {
+        ext::polymorphic_value<my_base> v {
+            std::allocator_arg, &resource, my_derived {123}};
+        ext::polymorphic_value<my_base> w {v};
+        CHECK(resource.allocations == 2);
+        CHECK(w->id() == 123);
+
+        ext::polymorphic_value<my_base> x {my_derived {456}};
+        x = w;
+        CHECK(resource.allocations == 3);
+        CHECK(x->id() == 123);
+    }
+
+    SECTION("allocator-extended copy uses given resource")
+    {
+        ext::polymorphic_value<my_base> v {my_derived {123}};
+        ext::polymorphic_value<my_base> w {std::allocator_arg, &resource, v};
+        CHECK(resource.allocations == 1);
+        CHECK(w->id() == 123);
+        CHECK(w->life() == 2);
+    }
+
+    SECTION("move keeps allocation")
+    {
+        ext::polymorphic_value<my_base> v {
+            std::allocator_arg, &resource, my_derived {123}};
+        ext::polymorphic_value<my_base> w {std::move(v)};
+        CHECK(resource.allocations == 1);
+        CHECK(resource.deallocations == 0);
+    }
+}
+
+namespace
+{
+    struct big_derived : my_derived
+    {
+        big_derived(long id)
+            : my_derived {id}
+        {
+        }
+
+        char padding[64] = {};
+    };
+
+    using small_value = ext::polymorphic_value<
+        my_base, ext::inline_storage<sizeof(my_derived), alignof(my_derived)>>;
+
+    bool is_inside(small_value const& v)
+    {
+        auto const begin = reinterpret_cast<std::uintptr_t>(&v);
+        auto const end = begin + sizeof v;
+        auto const address = reinterpret_cast<std::uintptr_t>(&v.value());
+        return address >= begin && address < end;
+    }
+}
+
+TEST_CASE("ext::polymorphic_value - inline storage")
+{
+    test::counting_resource resource;
+
+    SECTION("small object is stored in place")
+    {
+        small_value v {std::allocator_arg, &resource, my_derived {123}};
+        CHECK(resource.allocations == 0);
+        CHECK(is_inside(v));
+        CHECK(v->id() == 123);
+        CHECK(v->life() == 1);
+    }
+
+    SECTION("copy of small object is stored in place")
+    {
+        small_value v {std::allocator_arg, &resource, my_derived {123}};
+        small_value w {v};
+        CHECK(resource.allocations == 0);
+        CHECK(is_inside(w));
+        CHECK(w->id() == 123);
+        CHECK(w->life() == 2);
+    }
+
+    SECTION("move of small object recomputes the base pointer")
+    {
+        small_value v {my_derived {123}};
+        small_value w {std::move(v)};
+        CHECK(is_inside(w));
+        CHECK(w->id() == 123);
+        CHECK(w->life() == 1);
+
+        small_value x {my_derived {456}};
+        x = std::move(w);
+        CHECK(is_inside(x));
+        CHECK(x->id() == 123);
+        CHECK(x->life() == 1);
+    }
+
+    SECTION("large object is allocated from resource")
+    {
+        {
+            small_value v {std::allocator_arg, &resource, big_derived {123}};
+            CHECK(resource.allocations == 1);
+            CHECK_FALSE(is_inside(v));
+            CHECK(v->id() == 123);
+
+            small_value w {v};
+            CHECK(resource.allocations == 2);
+            CHECK(w->id() == 123);
+        }
+        CHECK(resource.deallocations == 2);
+    }
+
+    SECTION("swap of small and large objects")
+    {
+        small_value v {my_derived {123}};
+        small_value w {big_derived {456}};
+        v.swap(w);
+        CHECK(v->id() == 456);
+        CHECK(w->id() == 123);
+        CHECK(is_inside(w));
+        CHECK_FALSE(is_inside(v));
+        CHECK(v->life() == 1);
+        CHECK(w->life() == 1);
+    }
+
+    SECTION("emplace and assignment")
+    {
+        small_value v {my_derived {123}};
+        v.emplace<big_derived>(456);
+        CHECK(v->id() == 456);
+        v = my_derived {789};
+        CHECK(is_inside(v));
+        CHECK(v->id() == 789);
+        CHECK(v->life() == 1);
+    }
+}
+
+TEST_CASE("ext::polymorphic_value - default storage is a single pointer")
+{
+    CHECK(sizeof(ext::polymorphic_value<my_base>) == sizeof(void*));
+
+    // The heap block holds the table and the resource besides the object.
+    test::counting_resource resource;
+    ext::polymorphic_value<my_base> v {
+        std::allocator_arg, &resource, my_derived {123}};
+    CHECK(resource.bytes == 2 * sizeof(void*) + sizeof(my_derived));
+}
+
+namespace
+{
+    struct mixin
+    {
+        virtual ~mixin() = default;
+        long mixin_data = 0;
+    };
+
+    struct offset_derived : mixin, my_derived
+    {
+        offset_derived(long id)
+            : my_derived {id}
+        {
+        }
+    };
+
+    struct virtual_middle : virtual my_derived
+    {
+        virtual_middle(long id)
+            : my_derived {id}
+        {
+        }
+    };
+
+    struct virtual_derived : mixin, virtual_middle
+    {
+        virtual_derived(long id)
+            : my_derived {id}
+            , virtual_middle {id}
+        {
+        }
+    };
+}
+
+TEST_CASE("ext::polymorphic_value - base subobject at nonzero offset")
+{
+    ext::polymorphic_value<my_base> v {offset_derived {123}};
+    CHECK(v->id() == 123);
+    CHECK(v.as<offset_derived>().id() == 123);
+
+    ext::polymorphic_value<my_base> w {v};
+    CHECK(w->id() == 123);
+    CHECK(w->life() == 2);
+
+    ext::polymorphic_value<my_base> x {virtual_derived {456}};
+    ext::polymorphic_value<my_base> y {x};
+    CHECK(x->id() == 456);
+    CHECK(y->id() == 456);
+    CHECK(y->life() == 2);
+}
+
+namespace
+{
+    using closed_value = ext::polymorphic_value<
+        my_base, ext::closed_set<my_derived, offset_derived, big_derived>>;
+}
+
+TEST_CASE("ext::polymorphic_value - closed set")
+{
+    static_assert(sizeof(closed_value) <= sizeof(big_derived) + alignof(big_derived),
+                  "object should be stored in place");
+
+    SECTION("initialization and access")
+    {
+        closed_value v {offset_derived {123}};
+        CHECK(v.index() == 1);
+        CHECK(v->id() == 123);
+        CHECK(v.value().id() == 123);
+        CHECK(v.as<offset_derived>().id() == 123);
+
+        auto const begin = reinterpret_cast<std::uintptr_t>(&v);
+        auto const address = reinterpret_cast<std::uintptr_t>(&v.value());
+        CHECK(address >= begin);
+        CHECK(address < begin + sizeof v);
+    }
+
+    SECTION("copy")
+    {
+        closed_value v {my_derived {123}};
+        closed_value w {v};
+        CHECK(w.index() == 0);
+        CHECK(w->id() == 123);
+        CHECK(w->life() == 2);
+
+        closed_value x {big_derived {456}};
+        x = v;
+        CHECK(x.index() == 0);
+        CHECK(x->id() == 123);
+        CHECK(x->life() == 3);
+    }
+
+    SECTION("move")
+    {
+        closed_value v {big_derived {123}};
+        closed_value w {std::move(v)};
+        CHECK(w.index() == 2);
+        CHECK(w->id() == 123);
+        CHECK(w->life() == 1);
+
+        closed_value x {my_derived {456}};
+        x = std::move(w);
+        CHECK(x.index() == 2);
+        CHECK(x->id() == 123);
+        CHECK(x->life() == 1);
+    }
+
+    SECTION("assignment and emplace")
+    {
+        closed_value v {my_derived {123}};
+        v = big_derived {456};
+        CHECK(v.index() == 2);
+        CHECK(v->id() == 456);
+        CHECK(v->life() == 1);
+
+        v.emplace<offset_derived>(789);
+        CHECK(v.index() == 1);
+        CHECK(v->id() == 789);
+        CHECK(v->life() == 1);
+    }
+
+    SECTION("swap")
+    {
+        closed_value v {my_derived {123}};
+        closed_value w {offset_derived {456}};
+        v.swap(w);
+        CHECK(v->id() == 456);
+        CHECK(w->id() == 123);
+        CHECK(v.index() == 1);
+        CHECK(w.index() == 0);
+    }
+
+    SECTION("equality comparison")
+    {
+        closed_value const a {my_derived {123}};
+        closed_value const b {big_derived {123}};
+        closed_value const c {my_derived {456}};
+        CHECK(a == b);
+        CHECK(a != c);
+    }
+}
+
+TEST_CASE("ext::polymorphic_value - emplace and assignment reuse storage")
+{
+    test::counting_resource resource;
+
+    SECTION("same type is assigned in place")
+    {
+        ext::polymorphic_value<my_base> v {
+            std::allocator_arg, &resource, my_derived {123}};
+        auto const address = &v.value();
+
+        for (long i = 0; i < 10; ++i)
+            v = my_derived {i};
+        CHECK(resource.allocations == 1);
+        CHECK(&v.value() == address);
+        CHECK(v->id() == 9);
+        CHECK(v->life() == 1);
+    }
+
+    SECTION("emplace of same type reuses the block")
+    {
+        ext::polymorphic_value<my_base> v {
+            std::allocator_arg, &resource, my_derived {123}};
+        auto const address = &v.value();
+
+        v.emplace<my_derived>(my_derived {456});
+        CHECK(resource.allocations == 1);
+        CHECK(resource.deallocations == 0);
+        CHECK(&v.value() == address);
+        CHECK(v->id() == 456);
+    }
+
+    SECTION("emplace that may throw allocates a new block")
+    {
+        {
+            ext::polymorphic_value<my_base> v {
+                std::allocator_arg, &resource, my_derived {123}};
+
+            v.emplace<my_derived>(456);
+            CHECK(resource.allocations == 2);
+            CHECK(resource.deallocations == 1);
+            CHECK(v->id() == 456);
+        }
+        CHECK(resource.deallocations == 2);
+    }
+
+    SECTION("emplace from the contained object")
+    {
+        ext::polymorphic_value<my_base> v {
+            std::allocator_arg, &resource, my_derived {123}};
+
+        auto const& object = static_cast<my_derived const&>(v.value());
+        static_assert(
+            std::is_nothrow_copy_constructible<my_derived>::value, "");
+
+        v.emplace<my_derived>(object);
+        CHECK(resource.deallocations == 1);
+        CHECK(v->id() == 123);
+        CHECK(v->life() == 1);
+
+        v = static_cast<my_derived const&>(v.value());
+        CHECK(v->id() == 123);
+        CHECK(v->life() == 1);
+    }
+
+    SECTION("block of same size is reused for another type")
+    {
+        struct other_derived : my_derived
+        {
+            using my_derived::my_derived;
+
+            long id() const override
+            {
+                return -my_derived::id();
+            }
+        };
+        static_assert(sizeof(other_derived) == sizeof(my_derived), "");
+
+        {
+            ext::polymorphic_value<my_base> v {
+                std::allocator_arg, &resource, my_derived {123}};
+            v = other_derived {456};
+            CHECK(resource.allocations == 1);
+            CHECK(v->id() == -456);
+
+            ext::polymorphic_value<my_base> w {v};
+            CHECK(w->id() == -456);
+        }
+        CHECK(resource.deallocations == 2);
+    }
+
+    SECTION("block of different size is replaced")
+    {
+        {
+            ext::polymorphic_value<my_base> v {
+                std::allocator_arg, &resource, my_derived {123}};
+            v = big_derived {456};
+            CHECK(resource.allocations == 2);
+            CHECK(resource.deallocations == 1);
+            CHECK(v->id() == 456);
+        }
+        CHECK(resource.deallocations == 2);
+    }
+
+    SECTION("new block is allocated from the same resource")
+    {
+        {
+            small_value v {std::allocator_arg, &resource, big_derived {1}};
+            v = offset_derived {2};
+            CHECK(resource.allocations == 2);
+            CHECK(resource.deallocations == 1);
+            CHECK(v->id() == 2);
+
+            v = my_derived {3};
+            CHECK(resource.allocations == 2);
+            CHECK(resource.deallocations == 2);
+
+            // A local object does not record the resource.
+            v = big_derived {4};
+            CHECK(resource.allocations == 2);
+            CHECK(v->id() == 4);
+        }
+        CHECK(resource.deallocations == 2);
+    }
+
+    SECTION("inline storage assigns same type in place")
+    {
+        small_value v {my_derived {123}};
+        v = my_derived {456};
+        CHECK(v->id() == 456);
+        v.emplace<my_derived>(789);
+        CHECK(v->id() == 789);
+        CHECK(v->life() == 1);
+
+        small_value w {std::allocator_arg, &resource, big_derived {1}};
+        auto const address = &w.value();
+        w = big_derived {2};
+        w.emplace<big_derived>(big_derived {3});
+        CHECK(resource.allocations == 1);
+        CHECK(&w.value() == address);
+        CHECK(w->id() == 3);
+    }
+
+    SECTION("inline storage emplaces from the contained object")
+    {
+        small_value v {my_derived {123}};
+        v.emplace<my_derived>(static_cast<my_derived const&>(v.value()));
+        CHECK(v->id() == 123);
+        CHECK(v->life() == 1);
+
+        small_value w {std::allocator_arg, &resource, big_derived {456}};
+        w.emplace<big_derived>(static_cast<big_derived const&>(w.value()));
+        CHECK(resource.deallocations == 1);
+        CHECK(w->id() == 456);
+        CHECK(w->life() == 1);
+    }
+
+    SECTION("closed set assigns same type in place")
+    {
+        closed_value v {my_derived {123}};
+        v = my_derived {456};
+        CHECK(v.index() == 0);
+        CHECK(v->id() == 456);
+        CHECK(v->life() == 1);
+    }
+}
+
+namespace
+{
+    struct throwing_derived : my_derived
+    {
+        explicit throwing_derived(long id)
+            : my_derived {id}
+        {
+            if (id < 0)
+                throw std::runtime_error("negative id");
+        }
+    };
+}
+
+TEST_CASE("ext::polymorphic_value - emplace that throws keeps the value")
+{
+    test::counting_resource resource;
+    {
+        ext::polymorphic_value<my_base> v {
+            std::allocator_arg, &resource, throwing_derived {1}};
+        CHECK_THROWS_AS(v.emplace<throwing_derived>(-1), std::runtime_error const&);
+        CHECK(resource.allocations == 2);
+        CHECK(resource.deallocations == 1);
+        CHECK(v->id() == 1);
+        CHECK(v->life() == 1);
+
+        small_value w {throwing_derived {2}};
+        CHECK_THROWS_AS(w.emplace<throwing_derived>(-1), std::runtime_error const&);
+        CHECK(w->id() == 2);
+    }
+    CHECK(resource.deallocations == 2);
+}
+
+TEST_CASE("ext::bulk_clone - copies values into one arena block")
+{
+    test::counting_resource upstream;
+    ext::monotonic_buffer_resource arena {64, &upstream};
+
+    std::vector<ext::polymorphic_value<my_base>> values;
+    for (long i = 0; i < 100; ++i)
+    {
+        if (i % 3 == 0)
+            values.emplace_back(big_derived {i});
+        else if (i % 3 == 1)
+            values.emplace_back(offset_derived {i});
+        else
+            values.emplace_back(my_derived {i});
+    }
+
+    std::vector<ext::polymorphic_value<my_base>> copies;
+    copies.reserve(values.size());
+    ext::bulk_clone(values.begin(), values.end(), std::back_inserter(copies), arena);
+
+    CHECK(upstream.allocations == 1);
+    REQUIRE(copies.size() == values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        CHECK(copies[i]->id() == values[i]->id());
+        CHECK(&copies[i].value() != &values[i].value());
+        CHECK(copies[i]->life() == 2);
+    }
+    CHECK(copies[1].as<offset_derived>().id() == 1);
+
+    // Copies are independent of the originals.
+    copies[0] = my_derived {-1};
+    CHECK(values[0]->id() == 0);
+
+    // Copies of copies allocate from the arena.
+    ext::polymorphic_value<my_base> again {copies[2]};
+    CHECK(again->id() == 2);
+
+    copies.clear();
+    CHECK(values[5]->life() == 1);
+}
+
+TEST_CASE("ext::bulk_clone - empty range")
+{
+    test::counting_resource upstream;
+    ext::monotonic_buffer_resource arena {64, &upstream};
+
+    std::vector<ext::polymorphic_value<my_base>> values;
+    std::vector<ext::polymorphic_value<my_base>> copies;
+    ext::bulk_clone(values.begin(), values.end(), std::back_inserter(copies), arena);
+    CHECK(copies.empty());
+    CHECK(upstream.allocations == 0);
+}
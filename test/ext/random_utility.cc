@@ -1,10 +1,14 @@
+#include <algorithm>
 #include <array>
+#include <limits>
 #include <random>
+#include <vector>
 
 #include <cstdint>
 
 #include <catch.hpp>
 
+#include <ext/array_view.hpp>
 #include <ext/random_utility.hpp>
 
 
@@ -52,3 +56,63 @@ TEST_CASE("ext::seed_state")
         CHECK(state[3] > 0xffffffffu);
     }
 }
+
+TEST_CASE("ext::seed_state - array_view")
+{
+    SECTION("same as std::array")
+    {
+        std::array<std::uint64_t, 4> array {{}};
+        std::vector<std::uint64_t> vector(4);
+        std::seed_seq seed {1, 2, 3};
+        ext::seed_state(seed, array);
+        ext::seed_state(seed, ext::array_view<std::uint64_t>(vector));
+        CHECK(std::equal(array.begin(), array.end(), vector.begin()));
+    }
+
+    SECTION("large std::array is generated at once")
+    {
+        std::array<std::uint32_t, 624> array;
+        std::array<std::uint32_t, 624> expected;
+        std::seed_seq seed {1, 2, 3};
+        ext::seed_state(seed, array);
+        seed.generate(expected.begin(), expected.end());
+        CHECK(array == expected);
+    }
+
+    SECTION("large state")
+    {
+        // Spans many chunks of generated seed values.
+        std::vector<std::uint64_t> state(1000000);
+        std::vector<std::uint64_t> again(1000000);
+        std::seed_seq seed {1, 2, 3};
+        ext::seed_state(seed, ext::array_view<std::uint64_t>(state));
+        ext::seed_state(seed, ext::array_view<std::uint64_t>(again));
+        CHECK(state == again);
+
+        // Chunks must not repeat each other.
+        std::sort(state.begin(), state.end());
+        CHECK(std::adjacent_find(state.begin(), state.end()) == state.end());
+        CHECK(state.front() != 0u);
+    }
+
+    SECTION("large narrow state")
+    {
+        std::vector<std::uint32_t> state(1000);
+        std::seed_seq seed;
+        ext::seed_state(seed, ext::array_view<std::uint32_t>(state));
+        CHECK(state[0] != state[256]);
+        CHECK(state[255] != state[511]);
+        CHECK(std::count(state.begin(), state.end(), 0u) == 0);
+    }
+}
+
+TEST_CASE("ext::normal_quantile")
+{
+    CHECK(ext::normal_quantile(0.5) == 0);
+    CHECK(ext::normal_quantile(0.975) == Approx(1.959963984540054).epsilon(1e-8));
+    CHECK(ext::normal_quantile(0.025) == Approx(-1.959963984540054).epsilon(1e-8));
+    CHECK(ext::normal_quantile(0.8413447460685429) == Approx(1).epsilon(1e-8));
+    CHECK(ext::normal_quantile(1e-10) == Approx(-6.361340902404056).epsilon(1e-8));
+    CHECK(ext::normal_quantile(0) == -std::numeric_limits<double>::infinity());
+    CHECK(ext::normal_quantile(1) == std::numeric_limits<double>::infinity());
+}
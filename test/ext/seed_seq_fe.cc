@@ -0,0 +1,119 @@
+#include <array>
+#include <bitset>
+#include <iterator>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <catch.hpp>
+
+#include <ext/array_view.hpp>
+#include <ext/random_utility.hpp>
+#include <ext/seed_seq_fe.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+
+
+namespace
+{
+    constexpr
+    std::uint32_t first_seed_value()
+    {
+        ext::seed_seq_fe<2> seed {1u, 2u, 3u};
+        std::uint32_t values[1] = {};
+        seed.generate(values, values + 1);
+        return values[0];
+    }
+
+    static_assert(first_seed_value() != 0,
+                  "seed_seq_fe should be usable in constant expression");
+}
+
+TEST_CASE("ext::seed_seq_fe - SeedSequence requirements")
+{
+    CHECK((ext::is_seed_sequence<ext::seed_seq_fe<1>>::value));
+    CHECK((ext::is_seed_sequence<ext::seed_seq_fe<4>>::value));
+    CHECK(ext::seed_seq_fe<4>::size() == 4);
+    CHECK(sizeof(ext::seed_seq_fe<4>) == 4 * sizeof(std::uint32_t));
+
+    ext::seed_seq_fe<4> const seed {1, 2, 3};
+    std::vector<std::uint32_t> pool;
+    seed.param(std::back_inserter(pool));
+    CHECK(pool.size() == 4);
+}
+
+TEST_CASE("ext::seed_seq_fe - generate")
+{
+    ext::seed_seq_fe<4> const seed {1u, 2u, 3u, 4u};
+
+    SECTION("deterministic")
+    {
+        std::array<std::uint32_t, 8> a {{}};
+        std::array<std::uint32_t, 8> b {{}};
+        seed.generate(a.begin(), a.end());
+        seed.generate(b);
+        CHECK(a == b);
+    }
+
+    SECTION("output is longer than pool")
+    {
+        std::array<std::uint32_t, 12> values {{}};
+        seed.generate(values);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            CHECK(values[i] != values[i + 4]);
+            CHECK(values[i] != values[i + 8]);
+        }
+    }
+
+    SECTION("range constructor")
+    {
+        std::vector<std::uint32_t> const input {1, 2, 3, 4};
+        ext::seed_seq_fe<4> const other {input.begin(), input.end()};
+        std::array<std::uint32_t, 4> a {{}};
+        std::array<std::uint32_t, 4> b {{}};
+        seed.generate(a);
+        other.generate(b);
+        CHECK(a == b);
+    }
+}
+
+TEST_CASE("ext::seed_seq_fe - avalanche")
+{
+    // Flipping a single input bit should flip about half the output bits.
+    std::size_t flipped = 0;
+    std::size_t total = 0;
+
+    for (std::uint32_t input = 0; input < 64; ++input)
+    {
+        for (unsigned bit = 0; bit < 32; ++bit)
+        {
+            ext::seed_seq_fe<4> const seed_1 {input, 0u, 7u};
+            ext::seed_seq_fe<4> const seed_2 {input ^ (1u << bit), 0u, 7u};
+            std::array<std::uint32_t, 4> a {{}};
+            std::array<std::uint32_t, 4> b {{}};
+            seed_1.generate(a);
+            seed_2.generate(b);
+
+            for (std::size_t i = 0; i < 4; ++i)
+                flipped += std::bitset<32>(a[i] ^ b[i]).count();
+            total += 4 * 32;
+        }
+    }
+
+    auto const ratio = double(flipped) / double(total);
+    CHECK(ratio > 0.49);
+    CHECK(ratio < 0.51);
+}
+
+TEST_CASE("ext::seed_seq_fe - seeding engine")
+{
+    ext::seed_seq_fe<4> seed_1 {42u};
+    ext::seed_seq_fe<4> seed_2 {42u};
+    ext::seed_seq_fe<4> seed_3 {43u};
+    ext::sfc64 engine_1 {seed_1};
+    ext::sfc64 engine_2 {seed_2};
+    ext::sfc64 engine_3 {seed_3};
+    CHECK(engine_1 == engine_2);
+    CHECK(engine_1 != engine_3);
+}
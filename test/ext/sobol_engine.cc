@@ -0,0 +1,162 @@
+#include <set>
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <catch.hpp>
+
+#include <ext/array_view.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+#include <ext/sobol_engine.hpp>
+
+
+namespace
+{
+    // Checks that the first 2^k points hit every dyadic interval of width
+    // 2^-k exactly once in each coordinate.
+    bool is_stratified(std::vector<std::uint32_t> const& points,
+                       std::size_t dimension,
+                       unsigned k)
+    {
+        std::size_t const count = std::size_t(1) << k;
+        for (std::size_t dim = 0; dim < dimension; ++dim)
+        {
+            std::set<std::uint32_t> cells;
+            for (std::size_t i = 0; i < count; ++i)
+                cells.insert(points[i * dimension + dim] >> (32 - k));
+            if (cells.size() != count)
+                return false;
+        }
+        return true;
+    }
+}
+
+TEST_CASE("ext::sobol_engine - first points")
+{
+    ext::sobol_engine sobol {3};
+    CHECK(sobol.dimension() == 3);
+    CHECK(sobol.index() == 0);
+
+    std::vector<double> points(8 * 3);
+    sobol.fill(points);
+    CHECK(sobol.index() == 8);
+
+    std::vector<double> const expected {
+        0,     0,     0,
+        0.5,   0.5,   0.5,
+        0.75,  0.25,  0.25,
+        0.25,  0.75,  0.75,
+        0.375, 0.375, 0.625,
+        0.875, 0.875, 0.125,
+        0.625, 0.125, 0.875,
+        0.125, 0.625, 0.375
+    };
+    CHECK(points == expected);
+}
+
+TEST_CASE("ext::sobol_engine - stratification")
+{
+    auto const dim = ext::sobol_engine::max_dimension;
+    ext::sobol_engine sobol {dim};
+
+    std::vector<std::uint32_t> points(1024 * dim);
+    sobol.fill(points);
+    for (unsigned k = 1; k <= 10; ++k)
+        CHECK(is_stratified(points, dim, k));
+}
+
+TEST_CASE("ext::sobol_engine - seek")
+{
+    ext::sobol_engine stepped {5};
+    ext::sobol_engine sought {5};
+
+    std::vector<std::uint32_t> skipped(1000 * 5);
+    stepped.fill(skipped);
+    sought.seek(1000);
+    CHECK(stepped == sought);
+
+    std::vector<std::uint32_t> point_1(5);
+    std::vector<std::uint32_t> point_2(5);
+    stepped.fill(point_1);
+    sought.fill(point_2);
+    CHECK(point_1 == point_2);
+
+    sought.discard(41);
+    stepped.fill(ext::make_array_view(skipped.data(), 41 * 5));
+    stepped.fill(point_1);
+    sought.fill(point_2);
+    CHECK(point_1 == point_2);
+
+    // The last point of the sequence.
+    sought.seek((std::uint64_t(1) << 32) - 1);
+    sought.fill(point_2);
+    CHECK(sought.index() == (std::uint64_t(1) << 32));
+    CHECK(point_2[0] == 0x00000001u);
+}
+
+TEST_CASE("ext::sobol_engine - scrambling")
+{
+    ext::sfc64 engine;
+
+    SECTION("digital shift")
+    {
+        ext::sobol_engine sobol {8};
+        sobol.scramble(engine, ext::sobol_scrambling::digital_shift);
+        CHECK(sobol.scrambling() == ext::sobol_scrambling::digital_shift);
+
+        std::vector<std::uint32_t> points(256 * 8);
+        sobol.fill(points);
+        for (unsigned k = 1; k <= 8; ++k)
+            CHECK(is_stratified(points, 8, k));
+    }
+
+    SECTION("owen")
+    {
+        ext::sobol_engine sobol {8};
+        sobol.scramble(engine, ext::sobol_scrambling::owen);
+        CHECK(sobol.scrambling() == ext::sobol_scrambling::owen);
+
+        std::vector<std::uint32_t> points(256 * 8);
+        sobol.fill(points);
+        for (unsigned k = 1; k <= 8; ++k)
+            CHECK(is_stratified(points, 8, k));
+
+        // The origin should be moved.
+        CHECK(points[0] != 0);
+    }
+
+    SECTION("none")
+    {
+        ext::sobol_engine sobol {2};
+        ext::sobol_engine plain {2};
+        sobol.scramble(engine, ext::sobol_scrambling::owen);
+        sobol.scramble(engine, ext::sobol_scrambling::none);
+        CHECK(sobol == plain);
+    }
+}
+
+TEST_CASE("ext::sobol_engine - integration")
+{
+    // Integral of prod_i 3 x_i^2 over the unit cube is one.
+    std::size_t const dim = 6;
+    std::size_t const count = 1 << 14;
+
+    ext::sfc64 engine;
+    ext::sobol_engine sobol {dim};
+    sobol.scramble(engine, ext::sobol_scrambling::owen);
+
+    std::vector<double> points(count * dim);
+    sobol.fill(points);
+
+    double sum = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double f = 1;
+        for (std::size_t d = 0; d < dim; ++d)
+            f *= 3 * points[i * dim + d] * points[i * dim + d];
+        sum += f;
+    }
+    CHECK(std::fabs(sum / double(count) - 1) < 0.01);
+}
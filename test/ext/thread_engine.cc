@@ -0,0 +1,98 @@
+#include <thread>
+#include <vector>
+
+#include <cstdint>
+
+#include <catch.hpp>
+
+#include <ext/parallel_random.hpp>
+#include <ext/seed_seq_fe.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+#include <ext/thread_engine.hpp>
+
+
+namespace
+{
+    struct thread_record
+    {
+        std::uint64_t stream = 0;
+        std::uint64_t value = 0;
+    };
+
+    thread_record record_thread()
+    {
+        thread_record record;
+        std::thread thread {[&] {
+            record.stream = ext::thread_engine_stream();
+            record.value = ext::thread_engine()();
+        }};
+        thread.join();
+        return record;
+    }
+}
+
+TEST_CASE("ext::thread_engine")
+{
+    SECTION("returns the same engine within a thread")
+    {
+        bool same = false;
+        std::thread thread {[&] {
+            same = (&ext::thread_engine() == &ext::thread_engine());
+        }};
+        thread.join();
+        CHECK(same);
+    }
+
+    SECTION("is seeded with process seed and stream id")
+    {
+        ext::seed_thread_engines(123);
+        auto const record = record_thread();
+        CHECK(record.stream == 0);
+
+        ext::seed_seq_fe<4> seed {123, 0, 0, 0, 0x74687264};
+        ext::sfc64 expected {seed};
+        CHECK(record.value == expected());
+
+        auto chunk_engine = ext::make_chunk_engine(123, 0);
+        CHECK(record.value != chunk_engine());
+    }
+
+    SECTION("is reproducible given the same registration order")
+    {
+        ext::seed_thread_engines(42);
+        auto const first = record_thread();
+        auto const second = record_thread();
+
+        ext::seed_thread_engines(42);
+        CHECK(record_thread().value == first.value);
+        CHECK(record_thread().value == second.value);
+
+        CHECK(first.stream == 0);
+        CHECK(second.stream == 1);
+        CHECK(first.value != second.value);
+    }
+
+    SECTION("gives distinct streams to concurrent threads")
+    {
+        ext::seed_thread_engines(7);
+
+        std::vector<std::uint64_t> streams(8);
+        std::vector<std::thread> threads;
+        for (auto& stream : streams)
+        {
+            threads.emplace_back([&stream] {
+                stream = ext::thread_engine_stream<ext::sfc32>();
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        std::vector<bool> seen(streams.size());
+        for (auto const stream : streams)
+        {
+            REQUIRE(stream < seen.size());
+            CHECK_FALSE(seen[stream]);
+            seen[stream] = true;
+        }
+    }
+}
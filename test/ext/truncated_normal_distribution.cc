@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <cmath>
+
+#include <catch.hpp>
+
+#include <ext/array_view.hpp>
+#include <ext/small_fast_counting_engine_v4.hpp>
+#include <ext/truncated_normal_distribution.hpp>
+
+
+TEST_CASE("ext::truncated_normal_distribution - characteristics")
+{
+    ext::truncated_normal_distribution<double> const normal {1, 2, -1, 4};
+    CHECK(normal.mean() == 1);
+    CHECK(normal.stddev() == 2);
+    CHECK(normal.lower() == -1);
+    CHECK(normal.upper() == 4);
+    CHECK(normal.min() == -1);
+    CHECK(normal.max() == 4);
+    CHECK(normal == (ext::truncated_normal_distribution<double> {1, 2, -1, 4}));
+    CHECK(normal != (ext::truncated_normal_distribution<double> {1, 2, -1, 5}));
+}
+
+TEST_CASE("ext::truncated_normal_distribution - moment test", "[random]")
+{
+    auto const inf = std::numeric_limits<double>::infinity();
+
+    // Standard normal density and upper tail probability.
+    auto const pdf = [](double x) {
+        return std::isinf(x) ? 0 : std::exp(-x * x / 2) / 2.5066282746310002;
+    };
+    auto const tail = [](double x) {
+        return std::erfc(x / std::sqrt(2.0)) / 2;
+    };
+
+    // Covers all three samplers on both sides of the origin.
+    std::vector<std::pair<double, double>> const intervals {
+        {-inf, inf}, {-1, 1}, {-0.5, 3}, {0.1, 0.5}, {-inf, 0.3},
+        {1, inf}, {2, 2.2}, {5, 5.5}, {8, inf}, {-inf, -4}, {-3, -2.5}
+    };
+
+    ext::sfc64 engine;
+
+    for (auto const& interval : intervals)
+    {
+        auto const a = interval.first;
+        auto const b = interval.second;
+
+        // Sample a non-standard distribution and standardize the values.
+        double const mu = 10;
+        double const sigma = 3;
+        ext::truncated_normal_distribution<double> normal {
+            mu, sigma, mu + sigma * a, mu + sigma * b
+        };
+
+        auto const sample_count = 200000uL;
+        double sum = 0;
+        double sum_sq = 0;
+        double min = inf;
+        double max = -inf;
+        for (auto i = 0uL; i < sample_count; ++i)
+        {
+            auto const x = normal(engine);
+            min = std::min(min, x);
+            max = std::max(max, x);
+            auto const z = (x - mu) / sigma;
+            sum += z;
+            sum_sq += z * z;
+        }
+        CHECK(min >= normal.lower());
+        CHECK(max <= normal.upper());
+
+        // Use reflection to keep tail probabilities accurate.
+        auto const flip = (b <= 0);
+        auto const lo = flip ? -b : a;
+        auto const hi = flip ? -a : b;
+        auto const mass = tail(lo) - tail(hi);
+        auto const mean = (pdf(lo) - pdf(hi)) / mass;
+        auto const var = 1 + ((std::isinf(lo) ? 0 : lo * pdf(lo))
+                              - (std::isinf(hi) ? 0 : hi * pdf(hi))) / mass
+                         - mean * mean;
+
+        auto const sample_mean = sum / double(sample_count);
+        auto const sample_var = sum_sq / double(sample_count)
+                                - sample_mean * sample_mean;
+        auto const tolerance = 5 * std::sqrt(var / double(sample_count));
+        CHECK(std::fabs(sample_mean - (flip ? -mean : mean)) < tolerance);
+        CHECK(std::fabs(sample_var - var) < 0.05 * var);
+    }
+}
+
+namespace
+{
+    // Counts the numbers drawn from the wrapped engine.
+    struct counting_engine
+    {
+        using result_type = ext::sfc64::result_type;
+
+        static constexpr result_type min()
+        {
+            return ext::sfc64::min();
+        }
+
+        static constexpr result_type max()
+        {
+            return ext::sfc64::max();
+        }
+
+        result_type operator()()
+        {
+            ++count;
+            return engine();
+        }
+
+        ext::sfc64 engine;
+        unsigned long count = 0;
+    };
+}
+
+TEST_CASE("ext::truncated_normal_distribution - far tail", "[random]")
+{
+    // The acceptance factors of the samplers overflow here, and the uniform
+    // sampler would need hundreds of proposals per sample.
+    ext::truncated_normal_distribution<double> normal {0, 1, 40, 50};
+    counting_engine engine;
+
+    auto const sample_count = 10000uL;
+    double sum = 0;
+    for (auto i = 0uL; i < sample_count; ++i)
+    {
+        auto const x = normal(engine);
+        CHECK(x >= 40);
+        CHECK(x <= 50);
+        sum += x;
+    }
+    CHECK(engine.count < 4 * sample_count);
+
+    // The excess over 40 is nearly exponential with rate 40.
+    CHECK(std::fabs(sum / double(sample_count) - 40.025) < 0.002);
+}
+
+TEST_CASE("ext::truncated_normal_distribution - fill", "[random]")
+{
+    ext::truncated_normal_distribution<double> normal {0, 1, 3, 4};
+    std::vector<double> values(1000);
+    std::vector<double> expected(1000);
+
+    ext::sfc64 engine_1 {42};
+    ext::sfc64 engine_2 {42};
+    normal.fill(engine_1, values);
+    for (auto& value : expected)
+        value = normal(engine_2);
+
+    CHECK(values == expected);
+}
@@ -42,3 +42,11 @@ TEST_CASE("ext::type_map - example usage")
     CHECK(map.value<short>() == 200);
     CHECK(map.value<int>() == 400);
 }
+
+TEST_CASE("ext::type_id_of")
+{
+    CHECK(ext::type_id_of<int>() == ext::type_id_of<int>());
+    CHECK(ext::type_id_of<int>() != ext::type_id_of<long>());
+    CHECK(ext::type_id_of<int>() != ext::type_id_of<int const>());
+    CHECK(*ext::type_id_of<int>() == ext::type_directory::index<int>::value);
+}
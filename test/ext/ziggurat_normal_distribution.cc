@@ -41,3 +41,18 @@ TEST_CASE("ext::ziggurat_normal_distribution - moment test", "[random]")
         CHECK(estimated_moment == Approx(moments[order]).epsilon(tolerance));
     }
 }
+
+TEST_CASE("ext::ziggurat_normal_distribution - fill", "[random]")
+{
+    ext::ziggurat_normal_distribution<double> normal;
+    std::vector<double> values(1000);
+    std::vector<double> expected(1000);
+
+    std::mt19937 engine_1;
+    std::mt19937 engine_2;
+    normal.fill(engine_1, values);
+    for (auto& value : expected)
+        value = normal(engine_2);
+
+    CHECK(values == expected);
+}